@@ -0,0 +1,371 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "../core/AdblockContentFiltersProfile.h"
+#include "../core/Console.h"
+#include "../core/SessionsManager.h"
+#include "../core/SettingsManager.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+
+#include <algorithm>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
+#include <sys/resource.h>
+#endif
+
+using namespace Otter;
+
+struct BenchmarkRequest final
+{
+	QUrl baseUrl;
+	QUrl requestUrl;
+	NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
+};
+
+NetworkManager::ResourceType getResourceType(const QString &name)
+{
+	const QHash<QString, NetworkManager::ResourceType> types({{QLatin1String("document"), NetworkManager::MainFrameType}, {QLatin1String("main_frame"), NetworkManager::MainFrameType}, {QLatin1String("subdocument"), NetworkManager::SubFrameType}, {QLatin1String("sub_frame"), NetworkManager::SubFrameType}, {QLatin1String("popup"), NetworkManager::PopupType}, {QLatin1String("stylesheet"), NetworkManager::StyleSheetType}, {QLatin1String("script"), NetworkManager::ScriptType}, {QLatin1String("image"), NetworkManager::ImageType}, {QLatin1String("object"), NetworkManager::ObjectType}, {QLatin1String("object-subrequest"), NetworkManager::ObjectSubrequestType}, {QLatin1String("xmlhttprequest"), NetworkManager::XmlHttpRequestType}, {QLatin1String("xhr"), NetworkManager::XmlHttpRequestType}, {QLatin1String("fetch"), NetworkManager::XmlHttpRequestType}, {QLatin1String("websocket"), NetworkManager::WebSocketType}});
+
+	return types.value(name.toLower(), NetworkManager::OtherType);
+}
+
+QVector<BenchmarkRequest> loadHarCorpus(const QByteArray &data)
+{
+	const QJsonObject logObject(QJsonDocument::fromJson(data).object().value(QLatin1String("log")).toObject());
+	const QJsonArray pagesArray(logObject.value(QLatin1String("pages")).toArray());
+	const QJsonArray entriesArray(logObject.value(QLatin1String("entries")).toArray());
+	QHash<QString, QUrl> pages;
+	QVector<BenchmarkRequest> requests;
+	requests.reserve(entriesArray.count());
+
+	for (int i = 0; i < pagesArray.count(); ++i)
+	{
+		const QJsonObject pageObject(pagesArray.at(i).toObject());
+
+		pages[pageObject.value(QLatin1String("id")).toString()] = QUrl(pageObject.value(QLatin1String("title")).toString());
+	}
+
+	for (int i = 0; i < entriesArray.count(); ++i)
+	{
+		const QJsonObject entryObject(entriesArray.at(i).toObject());
+		const QJsonObject requestObject(entryObject.value(QLatin1String("request")).toObject());
+		BenchmarkRequest request;
+		request.requestUrl = QUrl(requestObject.value(QLatin1String("url")).toString());
+		request.baseUrl = pages.value(entryObject.value(QLatin1String("pageref")).toString());
+		request.resourceType = getResourceType(entryObject.value(QLatin1String("_resourceType")).toString());
+
+		if (!request.baseUrl.isValid())
+		{
+			const QJsonArray headersArray(requestObject.value(QLatin1String("headers")).toArray());
+
+			for (int j = 0; j < headersArray.count(); ++j)
+			{
+				const QJsonObject headerObject(headersArray.at(j).toObject());
+
+				if (headerObject.value(QLatin1String("name")).toString().compare(QLatin1String("referer"), Qt::CaseInsensitive) == 0)
+				{
+					request.baseUrl = QUrl(headerObject.value(QLatin1String("value")).toString());
+
+					break;
+				}
+			}
+		}
+
+		if (!request.baseUrl.isValid())
+		{
+			request.baseUrl = request.requestUrl;
+		}
+
+		if (request.requestUrl.isValid())
+		{
+			requests.append(request);
+		}
+	}
+
+	return requests;
+}
+
+QVector<BenchmarkRequest> loadTextCorpus(const QByteArray &data)
+{
+	QTextStream stream(data);
+	stream.setCodec("UTF-8");
+
+	QVector<BenchmarkRequest> requests;
+
+	while (!stream.atEnd())
+	{
+		const QString line(stream.readLine().trimmed());
+
+		if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+		{
+			continue;
+		}
+
+		const QStringList fields(line.split(QRegularExpression(QLatin1String("\\s+")), QString::SkipEmptyParts));
+
+		if (fields.count() < 2)
+		{
+			continue;
+		}
+
+		BenchmarkRequest request;
+		request.baseUrl = QUrl(fields.at(0));
+		request.requestUrl = QUrl(fields.at(1));
+		request.resourceType = ((fields.count() > 2) ? getResourceType(fields.at(2)) : NetworkManager::OtherType);
+
+		if (request.requestUrl.isValid())
+		{
+			requests.append(request);
+		}
+	}
+
+	return requests;
+}
+
+qint64 getPeakResidentSetSize()
+{
+#ifdef Q_OS_LINUX
+	QFile file(QLatin1String("/proc/self/status"));
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return -1;
+	}
+
+	QTextStream stream(&file);
+
+	while (!stream.atEnd())
+	{
+		const QString line(stream.readLine());
+
+		if (line.startsWith(QLatin1String("VmHWM:")))
+		{
+			return line.section(QLatin1Char(':'), 1).remove(QLatin1String("kB")).trimmed().toLongLong();
+		}
+	}
+
+	return -1;
+#elif defined(Q_OS_UNIX)
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return -1;
+	}
+
+#ifdef Q_OS_MACOS
+	return (usage.ru_maxrss / 1024);
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return -1;
+#endif
+}
+
+qint64 loadProfile(AdblockContentFiltersProfile *profile)
+{
+	QEventLoop eventLoop;
+	QElapsedTimer timer;
+
+	QObject::connect(profile, &AdblockContentFiltersProfile::rulesLoaded, &eventLoop, &QEventLoop::quit);
+
+	timer.start();
+
+	profile->checkUrl(QUrl(QLatin1String("http://localhost/")), QUrl(QLatin1String("http://localhost/")), NetworkManager::OtherType);
+
+	eventLoop.exec();
+
+	return timer.elapsed();
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication application(argc, argv);
+	application.setApplicationName(QLatin1String("otter-browser-content-filters-benchmark"));
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QLatin1String("Replays a request corpus against an Adblock filter list and reports content blocking performance"));
+	parser.addHelpOption();
+	parser.addPositionalArgument(QLatin1String("list"), QLatin1String("Adblock syntax filter list"));
+	parser.addPositionalArgument(QLatin1String("corpus"), QLatin1String("Requests corpus, either HAR or text file with \"<first party URL> <request URL> [<resource type>]\" lines"));
+	parser.addOption(QCommandLineOption(QLatin1String("engine"), QLatin1String("Runs only <engine> (automaton or trie) in this process; without it every engine is measured in a separate process"), QLatin1String("engine")));
+	parser.addOption(QCommandLineOption(QLatin1String("iterations"), QLatin1String("Replays corpus <amount> times"), QLatin1String("amount"), QLatin1String("1")));
+	parser.addOption(QCommandLineOption(QLatin1String("wildcards"), QLatin1String("Enables rules with wildcards")));
+	parser.process(application);
+
+	const QStringList arguments(parser.positionalArguments());
+
+	if (arguments.count() != 2)
+	{
+		parser.showHelp(1);
+	}
+
+	const QString engine(parser.value(QLatin1String("engine")));
+
+	if (engine.isEmpty())
+	{
+		const QStringList engines({QLatin1String("automaton"), QLatin1String("trie")});
+		int exitCode(0);
+
+		for (int i = 0; i < engines.count(); ++i)
+		{
+			QProcess process;
+			process.setProcessChannelMode(QProcess::ForwardedChannels);
+			process.start(QCoreApplication::applicationFilePath(), (QCoreApplication::arguments().mid(1) + QStringList({QLatin1String("--engine"), engines.at(i)})));
+
+			if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+			{
+				QTextStream(stderr) << "Benchmark of engine " << engines.at(i) << " failed\n";
+
+				exitCode = 1;
+			}
+		}
+
+		return exitCode;
+	}
+
+	if (engine != QLatin1String("automaton") && engine != QLatin1String("trie"))
+	{
+		QTextStream(stderr) << "Unknown engine: " << engine << '\n';
+
+		return 1;
+	}
+
+	QFile listFile(arguments.at(0));
+	QFile corpusFile(arguments.at(1));
+
+	if (!listFile.open(QIODevice::ReadOnly) || !corpusFile.open(QIODevice::ReadOnly))
+	{
+		QTextStream(stderr) << "Failed to open input files\n";
+
+		return 1;
+	}
+
+	const QByteArray corpusData(corpusFile.readAll());
+	const QVector<BenchmarkRequest> requests(corpusData.trimmed().startsWith('{') ? loadHarCorpus(corpusData) : loadTextCorpus(corpusData));
+
+	if (requests.isEmpty())
+	{
+		QTextStream(stderr) << "Corpus does not contain any requests\n";
+
+		return 1;
+	}
+
+	QTemporaryDir profileDirectory;
+
+	if (!profileDirectory.isValid() || !QDir().mkpath(profileDirectory.path() + QLatin1String("/contentBlocking")))
+	{
+		QTextStream(stderr) << "Failed to create temporary profile directory\n";
+
+		return 1;
+	}
+
+	Console::createInstance();
+	SessionsManager::createInstance(profileDirectory.path(), profileDirectory.path());
+	SettingsManager::createInstance(profileDirectory.path());
+
+	QFile profileFile(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/benchmark.txt")));
+
+	if (!profileFile.open(QIODevice::WriteOnly))
+	{
+		QTextStream(stderr) << "Failed to copy filter list\n";
+
+		return 1;
+	}
+
+	const QByteArray listData(listFile.readAll());
+
+	if (!listData.left(listData.indexOf('\n')).contains("[Adblock"))
+	{
+		profileFile.write("[Adblock Plus 2.0]\n");
+	}
+
+	profileFile.write(listData);
+	profileFile.close();
+
+	ContentFiltersProfile::ProfileSummary profileSummary;
+	profileSummary.name = QLatin1String("benchmark");
+	profileSummary.areWildcardsEnabled = parser.isSet(QLatin1String("wildcards"));
+
+	SettingsManager::setOption(SettingsManager::ContentBlocking_MatchingEngineOption, engine);
+
+	AdblockContentFiltersProfile profile(profileSummary, {}, ContentFiltersProfile::NoFlags);
+	QTextStream output(stdout);
+	const qint64 parseTime(loadProfile(&profile));
+
+	profile.clear();
+
+	const qint64 cacheLoadTime(loadProfile(&profile));
+	const int iterations(qMax(1, parser.value(QLatin1String("iterations")).toInt()));
+	QVector<qint64> latencies;
+	latencies.reserve(requests.count() * iterations);
+
+	QElapsedTimer totalTimer;
+	QElapsedTimer requestTimer;
+	int blockedAmount(0);
+
+	totalTimer.start();
+
+	for (int i = 0; i < iterations; ++i)
+	{
+		for (int j = 0; j < requests.count(); ++j)
+		{
+			const BenchmarkRequest &request(requests.at(j));
+
+			requestTimer.start();
+
+			if (profile.checkUrl(request.baseUrl, request.requestUrl, request.resourceType).isBlocked)
+			{
+				++blockedAmount;
+			}
+
+			latencies.append(requestTimer.nsecsElapsed());
+		}
+	}
+
+	const qint64 totalTime(qMax(Q_INT64_C(1), totalTimer.nsecsElapsed()));
+
+	std::sort(latencies.begin(), latencies.end());
+
+	output << "Engine: " << engine << '\n';
+	output << "  Requests: " << requests.count() << " x " << iterations << '\n';
+	output << "  Parse time (including cache write): " << parseTime << " ms\n";
+	output << "  Cache load time: " << cacheLoadTime << " ms\n";
+	output << "  Checks per second: " << static_cast<qint64>(latencies.count() * 1000000000.0 / totalTime) << '\n';
+	output << "  Latency p50: " << (latencies.at(latencies.count() / 2) / 1000.0) << " us\n";
+	output << "  Latency p99: " << (latencies.at(qMin((latencies.count() - 1), static_cast<int>(latencies.count() * 0.99))) / 1000.0) << " us\n";
+	output << "  Blocked requests: " << (blockedAmount / iterations) << '\n';
+	output << "  Peak RSS: " << getPeakResidentSetSize() << " KiB\n";
+
+	return 0;
+}
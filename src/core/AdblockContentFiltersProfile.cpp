@@ -23,14 +23,21 @@
 #include "Console.h"
 #include "Job.h"
 #include "SessionsManager.h"
+#include "SettingsManager.h"
 
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSaveFile>
+#include <QtCore/QSysInfo>
 #include <QtCore/QTextStream>
 
+#include <algorithm>
+
 namespace Otter
 {
 
@@ -38,13 +45,18 @@ QHash<QString, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersPr
 QHash<NetworkManager::ResourceType, AdblockContentFiltersProfile::RuleOption> AdblockContentFiltersProfile::m_resourceTypes({{NetworkManager::ImageType, ImageOption}, {NetworkManager::ScriptType, ScriptOption}, {NetworkManager::StyleSheetType, StyleSheetOption}, {NetworkManager::ObjectType, ObjectOption}, {NetworkManager::XmlHttpRequestType, XmlHttpRequestOption}, {NetworkManager::SubFrameType, SubDocumentOption},{NetworkManager::PopupType, PopupOption}, {NetworkManager::ObjectSubrequestType, ObjectSubRequestOption}, {NetworkManager::WebSocketType, WebSocketOption}});
 
 AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersProfile::ProfileSummary &profileSummary, const QStringList &languages, ContentFiltersProfile::ProfileFlags flags, QObject *parent) : ContentFiltersProfile(parent),
-	m_root(nullptr),
 	m_dataFetchJob(nullptr),
 	m_profileSummary(profileSummary),
+	m_domainExpression(QLatin1String("[:\?&/=]")),
+	m_rulesGeneration(0),
 	m_error(NoError),
 	m_flags(flags),
+	m_matchingEngine(AutomatonEngine),
+	m_isLoadingRequested(0),
 	m_wasLoaded(false)
 {
+	m_domainExpression.optimize();
+
 	if (!languages.isEmpty())
 	{
 		m_languages.reserve(languages.count());
@@ -65,7 +77,16 @@ AdblockContentFiltersProfile::AdblockContentFiltersProfile(const ContentFiltersP
 		m_languages = {QLocale::AnyLanguage};
 	}
 
+	handleOptionChanged(SettingsManager::ContentBlocking_MatchingEngineOption, SettingsManager::getOption(SettingsManager::ContentBlocking_MatchingEngineOption));
 	loadHeader();
+
+	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &AdblockContentFiltersProfile::handleOptionChanged);
+	connect(&m_loadingWatcher, &QFutureWatcher<LoadingResult>::finished, this, &AdblockContentFiltersProfile::handleRulesLoaded);
+}
+
+AdblockContentFiltersProfile::~AdblockContentFiltersProfile()
+{
+	m_loadingSynchronizer.waitForFinished();
 }
 
 void AdblockContentFiltersProfile::clear()
@@ -75,14 +96,12 @@ void AdblockContentFiltersProfile::clear()
 		return;
 	}
 
-	if (m_root)
-	{
-		QtConcurrent::run(this, &AdblockContentFiltersProfile::deleteNode, m_root);
-	}
+	m_rulesSetMutex.lock();
+	m_rulesSet.reset();
 
-	m_cosmeticFiltersRules.clear();
-	m_cosmeticFiltersDomainExceptions.clear();
-	m_cosmeticFiltersDomainRules.clear();
+	++m_rulesGeneration;
+
+	m_rulesSetMutex.unlock();
 
 	m_wasLoaded = false;
 }
@@ -127,7 +146,7 @@ void AdblockContentFiltersProfile::loadHeader()
 	}
 }
 
-void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
+void AdblockContentFiltersProfile::parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, TrieBuilder *builder, RulesSet *rulesSet)
 {
 	if (rule.isEmpty() || rule.startsWith(QLatin1Char('!')))
 	{
@@ -136,9 +155,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.startsWith(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
+		if (profileSummary.cosmeticFiltersMode == ContentFiltersManager::AllFilters)
 		{
-			m_cosmeticFiltersRules.append(rule.mid(2));
+			rulesSet->cosmeticFiltersRules.append(rule.mid(2));
 		}
 
 		return;
@@ -146,9 +165,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("##")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("##")), m_cosmeticFiltersDomainRules);
+			parseStyleSheetRule(rule.split(QLatin1String("##")), rulesSet->cosmeticFiltersDomainRules);
 		}
 
 		return;
@@ -156,9 +175,9 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 
 	if (rule.contains(QLatin1String("#@#")))
 	{
-		if (m_profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
+		if (profileSummary.cosmeticFiltersMode != ContentFiltersManager::NoFilters)
 		{
-			parseStyleSheetRule(rule.split(QLatin1String("#@#")), m_cosmeticFiltersDomainExceptions);
+			parseStyleSheetRule(rule.split(QLatin1String("#@#")), rulesSet->cosmeticFiltersDomainExceptions);
 		}
 
 		return;
@@ -183,37 +202,37 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		line = line.mid(1);
 	}
 
-	if (!m_profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
+	if (!profileSummary.areWildcardsEnabled && line.contains(QLatin1Char('*')))
 	{
 		return;
 	}
 
-	Node::Rule *definition(new Node::Rule());
-	definition->rule = rule;
-	definition->isException = line.startsWith(QLatin1String("@@"));
+	Node::Rule definition;
+	definition.rule = internString(rule, builder->strings);
+	definition.isException = line.startsWith(QLatin1String("@@"));
 
-	if (definition->isException)
+	if (definition.isException)
 	{
 		line = line.mid(2);
 	}
 
-	definition->needsDomainCheck = line.startsWith(QLatin1String("||"));
+	definition.needsDomainCheck = line.startsWith(QLatin1String("||"));
 
-	if (definition->needsDomainCheck)
+	if (definition.needsDomainCheck)
 	{
 		line = line.mid(2);
 	}
 
 	if (line.startsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = StartMatch;
+		definition.ruleMatch = StartMatch;
 
 		line = line.mid(1);
 	}
 
 	if (line.endsWith(QLatin1Char('|')))
 	{
-		definition->ruleMatch = ((definition->ruleMatch == StartMatch) ? ExactMatch : EndMatch);
+		definition.ruleMatch = ((definition.ruleMatch == StartMatch) ? ExactMatch : EndMatch);
 
 		line = line.left(line.length() - 1);
 	}
@@ -227,18 +246,18 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		{
 			const RuleOption option(m_options.value(optionName));
 
-			if ((!definition->isException || isOptionException) && (option == ElementHideOption || option == GenericHideOption))
+			if ((!definition.isException || isOptionException) && (option == ElementHideOption || option == GenericHideOption))
 			{
 				continue;
 			}
 
 			if (!isOptionException)
 			{
-				definition->ruleOptions |= option;
+				definition.ruleOptions |= option;
 			}
 			else if (option != WebSocketOption && option != PopupOption)
 			{
-				definition->ruleExceptions |= option;
+				definition.ruleExceptions |= option;
 			}
 		}
 		else if (optionName.startsWith(QLatin1String("domain")))
@@ -249,12 +268,12 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 			{
 				if (parsedDomains.at(j).startsWith(QLatin1Char('~')))
 				{
-					definition->allowedDomains.append(parsedDomains.at(j).mid(1));
+					definition.allowedDomains.append(internString(parsedDomains.at(j).mid(1), builder->strings));
 
 					continue;
 				}
 
-				definition->blockedDomains.append(parsedDomains.at(j));
+				definition.blockedDomains.append(internString(parsedDomains.at(j), builder->strings));
 			}
 		}
 		else
@@ -263,46 +282,63 @@ void AdblockContentFiltersProfile::parseRuleLine(const QString &rule)
 		}
 	}
 
-	Node *node(m_root);
+	if (definition.needsDomainCheck && definition.ruleMatch == ContainsMatch)
+	{
+		const QString domain(line.endsWith(QLatin1Char('^')) ? line.left(line.length() - 1) : line);
+		bool isDomain(!domain.isEmpty() && !domain.startsWith(QLatin1Char('.')) && !domain.endsWith(QLatin1Char('.')));
+
+		for (int i = 0; i < domain.length() && isDomain; ++i)
+		{
+			const QChar character(domain.at(i));
+
+			isDomain = ((character >= QLatin1Char('a') && character <= QLatin1Char('z')) || (character >= QLatin1Char('0') && character <= QLatin1Char('9')) || character == QLatin1Char('.') || character == QLatin1Char('-'));
+		}
+
+		if (isDomain)
+		{
+			definition.needsDomainCheck = false;
+
+			builder->domains[domain].append(builder->rules.count());
+			builder->rules.append(definition);
+
+			return;
+		}
+	}
+
+	int node(0);
 
 	for (int i = 0; i < line.length(); ++i)
 	{
 		const QChar value(line.at(i));
-		bool childrenExists(false);
+		const QVarLengthArray<int, 1> &children(builder->entries.at(node).children);
+		int nextNode(-1);
 
-		for (int j = 0; j < node->children.count(); ++j)
+		for (int j = 0; j < children.count(); ++j)
 		{
-			Node *nextNode(node->children.at(j));
-
-			if (nextNode->value == value)
+			if (builder->entries.at(children.at(j)).value == value)
 			{
-				node = nextNode;
-
-				childrenExists = true;
+				nextNode = children.at(j);
 
 				break;
 			}
 		}
 
-		if (!childrenExists)
+		if (nextNode < 0)
 		{
-			Node *newNode(new Node());
-			newNode->value = value;
+			TrieBuilder::Entry entry;
+			entry.value = value;
 
-			if (value == QLatin1Char('^'))
-			{
-				node->children.insert(0, newNode);
-			}
-			else
-			{
-				node->children.append(newNode);
-			}
+			nextNode = builder->entries.count();
 
-			node = newNode;
+			builder->entries[node].children.append(nextNode);
+			builder->entries.append(entry);
 		}
+
+		node = nextNode;
 	}
 
-	node->rules.append(definition);
+	builder->entries[node].rules.append(builder->rules.count());
+	builder->rules.append(definition);
 }
 
 void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list)
@@ -315,68 +351,273 @@ void AdblockContentFiltersProfile::parseStyleSheetRule(const QStringList &line,
 	}
 }
 
-void AdblockContentFiltersProfile::deleteNode(Node *node) const
+void AdblockContentFiltersProfile::compileTrie(const TrieBuilder &builder, RulesSet *rulesSet)
 {
-	for (int i = 0; i < node->children.count(); ++i)
+	QVector<int> entries;
+	entries.reserve(builder.entries.count());
+	entries.append(0);
+
+	rulesSet->nodes.storage.resize(builder.entries.count());
+	rulesSet->nodes.data = rulesSet->nodes.storage.constData();
+	rulesSet->nodes.amount = rulesSet->nodes.storage.count();
+	rulesSet->rules.clear();
+	rulesSet->rules.reserve(builder.rules.count());
+
+	for (int i = 0; i < entries.count(); ++i)
 	{
-		deleteNode(node->children.at(i));
+		const TrieBuilder::Entry &entry(builder.entries.at(entries.at(i)));
+		QVarLengthArray<int, 1> children(entry.children);
+
+		std::sort(children.begin(), children.end(), [&](int first, int second)
+		{
+			return (builder.entries.at(first).value < builder.entries.at(second).value);
+		});
+
+		Node &node(rulesSet->nodes.storage[i]);
+		node.value = entry.value;
+		node.firstChild = static_cast<quint32>(entries.count());
+		node.childrenAmount = static_cast<quint32>(children.count());
+		node.firstRule = static_cast<quint32>(rulesSet->rules.count());
+		node.rulesAmount = static_cast<quint32>(entry.rules.count());
+
+		for (int j = 0; j < entry.rules.count(); ++j)
+		{
+			rulesSet->rules.append(builder.rules.at(entry.rules.at(j)));
+		}
+
+		for (int j = 0; j < children.count(); ++j)
+		{
+			entries.append(children.at(j));
+		}
 	}
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	rulesSet->domainRules.clear();
+	rulesSet->domainRules.reserve(builder.domains.count());
+
+	QHash<QString, QVector<int> >::const_iterator iterator;
+
+	for (iterator = builder.domains.constBegin(); iterator != builder.domains.constEnd(); ++iterator)
 	{
-		delete node->rules.at(i);
+		QVector<int> rules;
+		rules.reserve(iterator.value().count());
+
+		for (int i = 0; i < iterator.value().count(); ++i)
+		{
+			rules.append(rulesSet->rules.count());
+
+			rulesSet->rules.append(builder.rules.at(iterator.value().at(i)));
+		}
+
+		rulesSet->domainRules[iterator.key()] = rules;
+	}
+}
+
+void AdblockContentFiltersProfile::compileAutomaton(RulesSet *rulesSet)
+{
+	for (int i = 0; i < rulesSet->nodes.count(); ++i)
+	{
+		Node &node(rulesSet->nodes.storage[i]);
+		node.hasWildcardChildren = (findChild(*rulesSet, node, QLatin1Char('*')) >= 0 || findChild(*rulesSet, node, QLatin1Char('^')) >= 0);
 	}
 
-	delete node;
+	for (int i = 0; i < rulesSet->nodes.count(); ++i)
+	{
+		const Node node(rulesSet->nodes.at(i));
+
+		for (quint32 j = node.firstChild; j < (node.firstChild + node.childrenAmount); ++j)
+		{
+			Node &child(rulesSet->nodes.storage[j]);
+			int failureNode(0);
+
+			if (i > 0)
+			{
+				int currentNode(static_cast<int>(node.failureNode));
+
+				while (true)
+				{
+					failureNode = findChild(*rulesSet, rulesSet->nodes.at(currentNode), child.value);
+
+					if (failureNode >= 0 || currentNode == 0)
+					{
+						break;
+					}
+
+					currentNode = static_cast<int>(rulesSet->nodes.at(currentNode).failureNode);
+				}
+
+				failureNode = qMax(0, failureNode);
+			}
+
+			const Node &failure(rulesSet->nodes.at(failureNode));
+
+			child.depth = (node.depth + 1);
+			child.failureNode = static_cast<quint32>(failureNode);
+			child.outputNode = ((failureNode > 0 && (failure.rulesAmount > 0 || failure.hasWildcardChildren)) ? static_cast<quint32>(failureNode) : failure.outputNode);
+		}
+	}
+}
+
+QString AdblockContentFiltersProfile::saveCache(const RulesSet &rulesSet, const ProfileSummary &profileSummary, const QString &path, const QString &cachePath)
+{
+	if (SessionsManager::isReadOnly())
+	{
+		return {};
+	}
+
+	const QFileInfo information(path);
+	QSaveFile file(cachePath);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return file.errorString();
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(CacheSignature) << static_cast<quint32>(CacheVersion) << information.size() << information.lastModified().toMSecsSinceEpoch() << getRulesChecksum(path) << static_cast<qint32>(profileSummary.cosmeticFiltersMode) << profileSummary.areWildcardsEnabled;
+	stream << static_cast<quint8>(QSysInfo::ByteOrder) << static_cast<quint32>(sizeof(Node)) << static_cast<quint32>(rulesSet.nodes.count());
+
+	const QByteArray padding(static_cast<int>((alignof(quint64) - (file.pos() % alignof(quint64))) % alignof(quint64)), 0);
+
+	stream.writeRawData(padding.constData(), padding.size());
+	stream.writeRawData(reinterpret_cast<const char*>(rulesSet.nodes.constBegin()), static_cast<int>(rulesSet.nodes.count() * sizeof(Node)));
+
+	stream << static_cast<quint32>(rulesSet.rules.count());
+
+	for (int i = 0; i < rulesSet.rules.count(); ++i)
+	{
+		const Node::Rule &rule(rulesSet.rules.at(i));
+
+		stream << rule.rule << rule.blockedDomains << rule.allowedDomains << static_cast<quint16>(rule.ruleOptions) << static_cast<quint16>(rule.ruleExceptions) << static_cast<quint8>(rule.ruleMatch) << rule.isException << rule.needsDomainCheck;
+	}
+
+	stream << rulesSet.domainRules << rulesSet.cosmeticFiltersRules << rulesSet.cosmeticFiltersDomainRules << rulesSet.cosmeticFiltersDomainExceptions;
+
+	if (!file.commit())
+	{
+		return file.errorString();
+	}
+
+	return {};
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const
+QString AdblockContentFiltersProfile::internString(const QString &string, QSet<QString> &strings)
+{
+	const QSet<QString>::const_iterator iterator(strings.constFind(string));
+
+	if (iterator != strings.constEnd())
+	{
+		return *iterator;
+	}
+
+	strings.insert(string);
+
+	return string;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkDomainRules(const RulesSet &rulesSet, const Request &request) const
 {
 	ContentFiltersManager::CheckResult result;
-	ContentFiltersManager::CheckResult currentResult;
 
-	for (int i = 0; i < subString.length(); ++i)
+	if (rulesSet.domainRules.isEmpty())
 	{
-		const QChar treeChar(subString.at(i));
-		bool childrenExists(false);
+		return result;
+	}
 
-		currentResult = evaluateNodeRules(node, currentRule, request);
+	for (int i = 0; i < request.requestSubdomains.count(); ++i)
+	{
+		const QString &domain(request.requestSubdomains.at(i));
+		const QHash<QString, QVector<int> >::const_iterator iterator(rulesSet.domainRules.constFind(domain));
 
-		if (currentResult.isBlocked)
+		if (iterator == rulesSet.domainRules.constEnd())
 		{
-			result = currentResult;
+			continue;
 		}
-		else if (currentResult.isException)
+
+		for (int j = 0; j < iterator.value().count(); ++j)
 		{
-			return currentResult;
+			const ContentFiltersManager::CheckResult currentResult(checkRuleMatch(rulesSet.rules.at(iterator.value().at(j)), domain, request));
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
+			}
 		}
+	}
 
-		for (int j = 0; j < node->children.count(); ++j)
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlAutomaton(const RulesSet &rulesSet, const Request &request) const
+{
+	ContentFiltersManager::CheckResult result(evaluateNodeRules(rulesSet, rulesSet.nodes.at(0), {}, request));
+
+	if (result.isException)
+	{
+		return result;
+	}
+
+	const int length(request.requestUrl.length());
+	int node(0);
+
+	for (int i = 0; i <= length; ++i)
+	{
+		ContentFiltersManager::CheckResult currentResult;
+
+		if (i > 0)
 		{
-			const Node *nextNode(node->children.at(j));
+			const QChar value(request.requestUrl.at(i - 1));
+			int nextNode(findChild(rulesSet, rulesSet.nodes.at(node), value));
 
-			if (nextNode->value == QLatin1Char('*'))
+			while (nextNode < 0 && node > 0)
 			{
-				const QString wildcardSubString(subString.mid(i));
+				node = static_cast<int>(rulesSet.nodes.at(node).failureNode);
+				nextNode = findChild(rulesSet, rulesSet.nodes.at(node), value);
+			}
 
-				for (int k = 0; k < wildcardSubString.length(); ++k)
-				{
-					currentResult = checkUrlSubstring(nextNode, wildcardSubString.right(wildcardSubString.length() - k), (currentRule + wildcardSubString.left(k)), request);
+			node = qMax(0, nextNode);
+		}
 
-					if (currentResult.isBlocked)
-					{
-						result = currentResult;
-					}
-					else if (currentResult.isException)
-					{
-						return currentResult;
-					}
-				}
+		if (i < length)
+		{
+			currentResult = checkWildcardChildren(rulesSet, rulesSet.nodes.at(0), i, {}, request);
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
 			}
+		}
 
-			if (nextNode->value == QLatin1Char('^') && !treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
+		const Node &currentNode(rulesSet.nodes.at(node));
+		quint32 matchedNode((node > 0 && (currentNode.rulesAmount > 0 || currentNode.hasWildcardChildren)) ? static_cast<quint32>(node) : currentNode.outputNode);
+
+		while (matchedNode > 0)
+		{
+			const Node &outputNode(rulesSet.nodes.at(static_cast<int>(matchedNode)));
+			const QString currentRule(request.requestUrl.mid((i - static_cast<int>(outputNode.depth)), static_cast<int>(outputNode.depth)));
+
+			currentResult = evaluateNodeRules(rulesSet, outputNode, currentRule, request);
+
+			if (currentResult.isBlocked)
 			{
-				currentResult = checkUrlSubstring(nextNode, subString.mid(i), currentRule, request);
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
+			}
+
+			if (i < length)
+			{
+				currentResult = checkWildcardChildren(rulesSet, outputNode, i, currentRule, request);
 
 				if (currentResult.isBlocked)
 				{
@@ -388,40 +629,50 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 				}
 			}
 
-			if (nextNode->value == treeChar)
-			{
-				node = nextNode;
-
-				childrenExists = true;
-
-				break;
-			}
-		}
-
-		if (!childrenExists)
-		{
-			return result;
+			matchedNode = outputNode.outputNode;
 		}
-
-		currentRule += treeChar;
 	}
 
-	currentResult = evaluateNodeRules(node, currentRule, request);
+	return result;
+}
 
-	if (currentResult.isBlocked)
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkWildcardChildren(const RulesSet &rulesSet, const Node &node, int position, const QString &currentRule, const Request &request) const
+{
+	ContentFiltersManager::CheckResult result;
+
+	if (!node.hasWildcardChildren)
 	{
-		result = currentResult;
+		return result;
 	}
-	else if (currentResult.isException)
+
+	const QChar treeChar(request.requestUrl.at(position));
+	const int wildcardNode(findChild(rulesSet, node, QLatin1Char('*')));
+	ContentFiltersManager::CheckResult currentResult;
+
+	if (wildcardNode >= 0)
 	{
-		return currentResult;
+		for (int i = position; i < request.requestUrl.length(); ++i)
+		{
+			currentResult = checkUrlSubstring(rulesSet, wildcardNode, i, (currentRule + request.requestUrl.mid(position, (i - position))), request);
+
+			if (currentResult.isBlocked)
+			{
+				result = currentResult;
+			}
+			else if (currentResult.isException)
+			{
+				return currentResult;
+			}
+		}
 	}
 
-	for (int i = 0; i < node->children.count(); ++i)
+	if (!treeChar.isDigit() && !treeChar.isLetter() && treeChar != QLatin1Char('_') && treeChar != QLatin1Char('-') && treeChar != QLatin1Char('.') && treeChar != QLatin1Char('%'))
 	{
-		if (node->children.at(i)->value == QLatin1Char('^'))
+		const int separatorNode(findChild(rulesSet, node, QLatin1Char('^')));
+
+		if (separatorNode >= 0)
 		{
-			currentResult = evaluateNodeRules(node, currentRule, request);
+			currentResult = checkUrlSubstring(rulesSet, separatorNode, position, currentRule, request);
 
 			if (currentResult.isBlocked)
 			{
@@ -437,9 +688,64 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstri
 	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrlSubstring(const RulesSet &rulesSet, int node, int position, QString currentRule, const Request &request) const
 {
-	switch (rule->ruleMatch)
+	ContentFiltersManager::CheckResult result;
+	ContentFiltersManager::CheckResult currentResult;
+
+	for (int i = position; i < request.requestUrl.length(); ++i)
+	{
+		const QChar treeChar(request.requestUrl.at(i));
+
+		currentResult = evaluateNodeRules(rulesSet, rulesSet.nodes.at(node), currentRule, request);
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+
+		currentResult = checkWildcardChildren(rulesSet, rulesSet.nodes.at(node), i, currentRule, request);
+
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
+		}
+
+		node = findChild(rulesSet, rulesSet.nodes.at(node), treeChar);
+
+		if (node < 0)
+		{
+			return result;
+		}
+
+		currentRule += treeChar;
+	}
+
+	currentResult = evaluateNodeRules(rulesSet, rulesSet.nodes.at(node), currentRule, request);
+
+	if (currentResult.isBlocked)
+	{
+		result = currentResult;
+	}
+	else if (currentResult.isException)
+	{
+		return currentResult;
+	}
+
+	return result;
+}
+
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(const Node::Rule &rule, const QString &currentRule, const Request &request) const
+{
+	switch (rule.ruleMatch)
 	{
 		case StartMatch:
 			if (!request.requestUrl.startsWith(currentRule))
@@ -471,20 +777,18 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 			break;
 	}
 
-	const QStringList requestSubdomainList(ContentFiltersManager::createSubdomainList(request.requestHost));
-
-	if (rule->needsDomainCheck && !requestSubdomainList.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
+	if (rule.needsDomainCheck && !request.requestSubdomains.contains(currentRule.left(currentRule.indexOf(m_domainExpression))))
 	{
 		return {};
 	}
 
-	const bool hasBlockedDomains(!rule->blockedDomains.isEmpty());
-	const bool hasAllowedDomains(!rule->allowedDomains.isEmpty());
+	const bool hasBlockedDomains(!rule.blockedDomains.isEmpty());
+	const bool hasAllowedDomains(!rule.allowedDomains.isEmpty());
 	bool isBlocked(true);
 
 	if (hasBlockedDomains)
 	{
-		isBlocked = resolveDomainExceptions(request.baseHost, rule->blockedDomains);
+		isBlocked = resolveDomainExceptions(request.baseHost, rule.blockedDomains);
 
 		if (!isBlocked)
 		{
@@ -492,21 +796,21 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 		}
 	}
 
-	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule->allowedDomains) : isBlocked);
+	isBlocked = (hasAllowedDomains ? !resolveDomainExceptions(request.baseHost, rule.allowedDomains) : isBlocked);
 
-	if (rule->ruleOptions.testFlag(ThirdPartyOption) || rule->ruleExceptions.testFlag(ThirdPartyOption))
+	if (rule.ruleOptions.testFlag(ThirdPartyOption) || rule.ruleExceptions.testFlag(ThirdPartyOption))
 	{
-		if (request.baseHost.isEmpty() || requestSubdomainList.contains(request.baseHost))
+		if (request.baseHost.isEmpty() || request.requestSubdomains.contains(request.baseHost))
 		{
-			isBlocked = rule->ruleExceptions.testFlag(ThirdPartyOption);
+			isBlocked = rule.ruleExceptions.testFlag(ThirdPartyOption);
 		}
 		else if (!hasBlockedDomains && !hasAllowedDomains)
 		{
-			isBlocked = rule->ruleOptions.testFlag(ThirdPartyOption);
+			isBlocked = rule.ruleOptions.testFlag(ThirdPartyOption);
 		}
 	}
 
-	if (rule->ruleOptions != NoOption || rule->ruleExceptions != NoOption)
+	if (rule.ruleOptions != NoOption || rule.ruleExceptions != NoOption)
 	{
 		QHash<NetworkManager::ResourceType, RuleOption>::const_iterator iterator;
 
@@ -514,15 +818,15 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 		{
 			const bool supportsException(iterator.value() != WebSocketOption && iterator.value() != PopupOption);
 
-			if (rule->ruleOptions.testFlag(iterator.value()) || (supportsException && rule->ruleExceptions.testFlag(iterator.value())))
+			if (rule.ruleOptions.testFlag(iterator.value()) || (supportsException && rule.ruleExceptions.testFlag(iterator.value())))
 			{
 				if (request.resourceType == iterator.key())
 				{
-					isBlocked = (isBlocked ? rule->ruleOptions.testFlag(iterator.value()) : isBlocked);
+					isBlocked = (isBlocked ? rule.ruleOptions.testFlag(iterator.value()) : isBlocked);
 				}
 				else if (supportsException)
 				{
-					isBlocked = (isBlocked ? rule->ruleExceptions.testFlag(iterator.value()) : isBlocked);
+					isBlocked = (isBlocked ? rule.ruleExceptions.testFlag(iterator.value()) : isBlocked);
 				}
 				else
 				{
@@ -539,18 +843,18 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkRuleMatch(
 	if (isBlocked)
 	{
 		ContentFiltersManager::CheckResult result;
-		result.rule = rule->rule;
+		result.rule = rule.rule;
 
-		if (rule->isException)
+		if (rule.isException)
 		{
 			result.isBlocked = false;
 			result.isException = true;
 
-			if (rule->ruleOptions.testFlag(ElementHideOption))
+			if (rule.ruleOptions.testFlag(ElementHideOption))
 			{
 				result.comesticFiltersMode = ContentFiltersManager::NoFilters;
 			}
-			else if (rule->ruleOptions.testFlag(GenericHideOption))
+			else if (rule.ruleOptions.testFlag(GenericHideOption))
 			{
 				result.comesticFiltersMode = ContentFiltersManager::DomainOnlyFilters;
 			}
@@ -629,17 +933,60 @@ void AdblockContentFiltersProfile::handleJobFinished(bool isSuccess)
 		Console::addMessage(QCoreApplication::translate("main", "Failed to update content blocking profile: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, file.fileName());
 	}
 
-	clear();
+	const bool wasLoaded(m_wasLoaded);
+
+	m_wasLoaded = false;
+
 	loadHeader();
 
-	if (m_wasLoaded)
+	if (wasLoaded)
 	{
 		loadRules();
 	}
+	else
+	{
+		QFile::remove(getCachePath());
+	}
 
 	emit profileModified();
 }
 
+void AdblockContentFiltersProfile::handleOptionChanged(int identifier, const QVariant &value)
+{
+	if (identifier == SettingsManager::ContentBlocking_MatchingEngineOption)
+	{
+		m_matchingEngine.storeRelease((value.toString() == QLatin1String("trie")) ? TrieEngine : AutomatonEngine);
+
+		ContentFiltersManager::clearCache();
+	}
+}
+
+void AdblockContentFiltersProfile::handleRulesLoaded()
+{
+	const LoadingResult result(m_loadingWatcher.result());
+
+	if (!result.rulesSet)
+	{
+		return;
+	}
+
+	if (!result.errorString.isEmpty())
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save content blocking profile cache: %1").arg(result.errorString), Console::OtherCategory, Console::WarningLevel, getCachePath());
+	}
+
+	if (result.isCached)
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Content blocking profile %1 loaded from cache in %2 ms").arg(m_profileSummary.name).arg(result.loadingTime), Console::OtherCategory, Console::LogLevel, getCachePath());
+	}
+	else
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Content blocking profile %1 parsed in %2 ms").arg(m_profileSummary.name).arg(result.loadingTime), Console::OtherCategory, Console::LogLevel, getPath());
+	}
+
+	emit rulesLoaded();
+}
+
 void AdblockContentFiltersProfile::setProfileSummary(const ContentFiltersProfile::ProfileSummary &profileSummary)
 {
 	const bool needsReload(profileSummary.cosmeticFiltersMode != m_profileSummary.cosmeticFiltersMode || profileSummary.areWildcardsEnabled != m_profileSummary.areWildcardsEnabled);
@@ -678,6 +1025,33 @@ QString AdblockContentFiltersProfile::getPath() const
 	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.txt")).arg(m_profileSummary.name);
 }
 
+QString AdblockContentFiltersProfile::getCachePath() const
+{
+	return SessionsManager::getWritableDataPath(QLatin1String("contentBlocking/%1.dat")).arg(m_profileSummary.name);
+}
+
+QByteArray AdblockContentFiltersProfile::getRulesChecksum(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+
+	return hash.result();
+}
+
+QSharedPointer<const AdblockContentFiltersProfile::RulesSet> AdblockContentFiltersProfile::getRulesSet() const
+{
+	QMutexLocker locker(&m_rulesSetMutex);
+
+	return m_rulesSet;
+}
+
 QDateTime AdblockContentFiltersProfile::getLastUpdate() const
 {
 	return m_profileSummary.lastUpdate;
@@ -701,16 +1075,22 @@ ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCo
 	}
 
 	ContentFiltersManager::CosmeticFiltersResult result;
+	const QSharedPointer<const RulesSet> rulesSet(getRulesSet());
+
+	if (!rulesSet)
+	{
+		return result;
+	}
 
 	if (!isDomainOnly)
 	{
-		result.rules = m_cosmeticFiltersRules;
+		result.rules = rulesSet->cosmeticFiltersRules;
 	}
 
 	for (int i = 0; i < domains.count(); ++i)
 	{
-		result.rules.append(m_cosmeticFiltersDomainRules.values(domains.at(i)));
-		result.exceptions.append(m_cosmeticFiltersDomainExceptions.values(domains.at(i)));
+		result.rules.append(rulesSet->cosmeticFiltersDomainRules.values(domains.at(i)));
+		result.exceptions.append(rulesSet->cosmeticFiltersDomainExceptions.values(domains.at(i)));
 	}
 
 	return result;
@@ -719,17 +1099,41 @@ ContentFiltersManager::CosmeticFiltersResult AdblockContentFiltersProfile::getCo
 ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType)
 {
 	ContentFiltersManager::CheckResult result;
+	const QSharedPointer<const RulesSet> rulesSet(getRulesSet());
 
-	if (!m_wasLoaded && !loadRules())
+	if (!rulesSet)
 	{
+		if (thread() == QThread::currentThread())
+		{
+			loadRules();
+		}
+		else if (m_isLoadingRequested.testAndSetOrdered(0, 1))
+		{
+			QMetaObject::invokeMethod(this, "loadRules", Qt::QueuedConnection);
+		}
+
 		return result;
 	}
 
 	const Request request(baseUrl, requestUrl, resourceType);
 
+	result = checkDomainRules(*rulesSet, request);
+
+	if (result.isException)
+	{
+		return result;
+	}
+
+	if (m_matchingEngine.loadAcquire() == AutomatonEngine)
+	{
+		const ContentFiltersManager::CheckResult currentResult(checkUrlAutomaton(*rulesSet, request));
+
+		return ((currentResult.isBlocked || currentResult.isException) ? currentResult : result);
+	}
+
 	for (int i = 0; i < request.requestUrl.length(); ++i)
 	{
-		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(m_root, request.requestUrl.right(request.requestUrl.length() - i), {}, request));
+		const ContentFiltersManager::CheckResult currentResult(checkUrlSubstring(*rulesSet, 0, i, {}, request));
 
 		if (currentResult.isBlocked)
 		{
@@ -744,30 +1148,39 @@ ContentFiltersManager::CheckResult AdblockContentFiltersProfile::checkUrl(const
 	return result;
 }
 
-ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const
+ContentFiltersManager::CheckResult AdblockContentFiltersProfile::evaluateNodeRules(const RulesSet &rulesSet, const Node &node, const QString &currentRule, const Request &request) const
 {
 	ContentFiltersManager::CheckResult result;
 
-	for (int i = 0; i < node->rules.count(); ++i)
+	for (quint32 i = node.firstRule; i < (node.firstRule + node.rulesAmount); ++i)
 	{
-		if (node->rules.at(i))
-		{
-			ContentFiltersManager::CheckResult currentResult(checkRuleMatch(node->rules.at(i), currentRule, request));
+		const ContentFiltersManager::CheckResult currentResult(checkRuleMatch(rulesSet.rules.at(static_cast<int>(i)), currentRule, request));
 
-			if (currentResult.isBlocked)
-			{
-				result = currentResult;
-			}
-			else if (currentResult.isException)
-			{
-				return currentResult;
-			}
+		if (currentResult.isBlocked)
+		{
+			result = currentResult;
+		}
+		else if (currentResult.isException)
+		{
+			return currentResult;
 		}
 	}
 
 	return result;
 }
 
+int AdblockContentFiltersProfile::findChild(const RulesSet &rulesSet, const Node &node, QChar value)
+{
+	const Node *begin(rulesSet.nodes.constBegin() + node.firstChild);
+	const Node *end(begin + node.childrenAmount);
+	const Node *iterator(std::lower_bound(begin, end, value, [&](const Node &child, QChar childValue)
+	{
+		return (child.value < childValue);
+	}));
+
+	return ((iterator != end && iterator->value == value) ? static_cast<int>(iterator - rulesSet.nodes.constBegin()) : -1);
+}
+
 AdblockContentFiltersProfile::HeaderInformation AdblockContentFiltersProfile::loadHeader(QIODevice *rulesDevice)
 {
 	HeaderInformation information;
@@ -962,10 +1375,160 @@ bool AdblockContentFiltersProfile::create(const ContentFiltersProfile::ProfileSu
 	return true;
 }
 
+QSharedPointer<const AdblockContentFiltersProfile::RulesSet> AdblockContentFiltersProfile::loadCache(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath)
+{
+	const QFileInfo information(path);
+	QSharedPointer<QFile> file(new QFile(cachePath));
+
+	if (!information.exists() || !file->open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+
+	QDataStream stream(file.data());
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	QByteArray checksum;
+	qint64 size(0);
+	qint64 lastModified(0);
+	quint32 signature(0);
+	quint32 version(0);
+	qint32 cosmeticFiltersMode(0);
+	bool areWildcardsEnabled(false);
+
+	stream >> signature >> version >> size >> lastModified >> checksum >> cosmeticFiltersMode >> areWildcardsEnabled;
+
+	if (stream.status() != QDataStream::Ok || signature != CacheSignature || version != CacheVersion || size != information.size() || cosmeticFiltersMode != profileSummary.cosmeticFiltersMode || areWildcardsEnabled != profileSummary.areWildcardsEnabled || (lastModified != information.lastModified().toMSecsSinceEpoch() && checksum != getRulesChecksum(path)))
+	{
+		return {};
+	}
+
+	QSharedPointer<RulesSet> rulesSet(new RulesSet());
+	NodesPool &nodes(rulesSet->nodes);
+	QVector<Node::Rule> &rules(rulesSet->rules);
+	QHash<QString, QVector<int> > &domainRules(rulesSet->domainRules);
+	QSet<QString> strings;
+	quint32 nodeSize(0);
+	quint32 nodesAmount(0);
+	quint8 byteOrder(0);
+
+	stream >> byteOrder >> nodeSize >> nodesAmount;
+
+	if (stream.status() != QDataStream::Ok || byteOrder != static_cast<quint8>(QSysInfo::ByteOrder) || nodeSize != sizeof(Node) || nodesAmount == 0 || nodesAmount > static_cast<quint64>(file->size() / static_cast<qint64>(sizeof(Node))))
+	{
+		return {};
+	}
+
+	const int paddingSize(static_cast<int>((alignof(quint64) - (file->pos() % alignof(quint64))) % alignof(quint64)));
+	const int nodesSize(static_cast<int>(nodesAmount * sizeof(Node)));
+
+	if (stream.skipRawData(paddingSize) != paddingSize || (file->pos() + nodesSize) > file->size())
+	{
+		return {};
+	}
+
+	const uchar *data(file->map(file->pos(), nodesSize));
+
+	if (!data || stream.skipRawData(nodesSize) != nodesSize)
+	{
+		return {};
+	}
+
+	nodes.file = file;
+	nodes.data = reinterpret_cast<const Node*>(data);
+	nodes.amount = static_cast<int>(nodesAmount);
+
+	quint32 rulesAmount(0);
+
+	stream >> rulesAmount;
+
+	for (quint32 i = 0; i < rulesAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		Node::Rule rule;
+		QStringList blockedDomains;
+		QStringList allowedDomains;
+		quint16 ruleOptions(NoOption);
+		quint16 ruleExceptions(NoOption);
+		quint8 ruleMatch(ContainsMatch);
+
+		QString ruleText;
+
+		stream >> ruleText >> blockedDomains >> allowedDomains >> ruleOptions >> ruleExceptions >> ruleMatch >> rule.isException >> rule.needsDomainCheck;
+
+		rule.rule = internString(ruleText, strings);
+
+		for (int j = 0; j < blockedDomains.count(); ++j)
+		{
+			rule.blockedDomains.append(internString(blockedDomains.at(j), strings));
+		}
+
+		for (int j = 0; j < allowedDomains.count(); ++j)
+		{
+			rule.allowedDomains.append(internString(allowedDomains.at(j), strings));
+		}
+
+		rule.ruleOptions = RuleOptions(QFlag(ruleOptions));
+		rule.ruleExceptions = RuleOptions(QFlag(ruleExceptions));
+		rule.ruleMatch = static_cast<RuleMatch>(ruleMatch);
+
+		rules.append(rule);
+	}
+
+	stream >> domainRules >> rulesSet->cosmeticFiltersRules >> rulesSet->cosmeticFiltersDomainRules >> rulesSet->cosmeticFiltersDomainExceptions;
+
+	bool isValid(nodes.count() > 0 && stream.status() == QDataStream::Ok && stream.atEnd());
+
+	for (int i = 0; i < nodes.count() && isValid; ++i)
+	{
+		const Node &node(nodes.at(i));
+
+		isValid = ((node.childrenAmount == 0 || (node.firstChild > static_cast<quint32>(i) && (static_cast<quint64>(node.firstChild) + node.childrenAmount) <= static_cast<quint64>(nodes.count()))) && (static_cast<quint64>(node.firstRule) + node.rulesAmount) <= static_cast<quint64>(rules.count()));
+
+		if (!isValid)
+		{
+			break;
+		}
+
+		// Nodes are stored in breadth-first order, so failure and output links always point backwards, which rules out cycles in the matching loops
+		if (i == 0)
+		{
+			isValid = (node.failureNode == 0 && node.outputNode == 0 && node.depth == 0);
+		}
+		else
+		{
+			isValid = (node.failureNode < static_cast<quint32>(i) && node.outputNode < static_cast<quint32>(i) && nodes.at(static_cast<int>(node.failureNode)).depth < node.depth);
+		}
+	}
+
+	QHash<QString, QVector<int> >::const_iterator iterator;
+
+	for (iterator = domainRules.constBegin(); iterator != domainRules.constEnd() && isValid; ++iterator)
+	{
+		for (int i = 0; i < iterator.value().count() && isValid; ++i)
+		{
+			isValid = (iterator.value().at(i) >= 0 && iterator.value().at(i) < rules.count());
+		}
+	}
+
+	if (!isValid)
+	{
+		return {};
+	}
+
+	return rulesSet;
+}
+
 bool AdblockContentFiltersProfile::loadRules()
 {
 	const QString path(getPath());
 
+	m_isLoadingRequested.storeRelease(0);
+
+	if (m_wasLoaded)
+	{
+		return true;
+	}
+
 	m_error = NoError;
 
 	if (!QFile::exists(path) && !m_profileSummary.updateUrl.isEmpty())
@@ -977,31 +1540,100 @@ bool AdblockContentFiltersProfile::loadRules()
 
 	m_wasLoaded = true;
 
-	if (m_domainExpression.pattern().isEmpty())
+	const bool canKeepPrevious(SettingsManager::getOption(SettingsManager::ContentBlocking_PendingRulesPolicyOption).toString() == QLatin1String("keepPrevious"));
+	const ProfileSummary profileSummary(m_profileSummary);
+	const QString cachePath(getCachePath());
+
+	m_rulesSetMutex.lock();
+
+	if (!canKeepPrevious)
 	{
-		m_domainExpression = QRegularExpression(QLatin1String("[:\?&/=]"));
-		m_domainExpression.optimize();
+		m_rulesSet.reset();
 	}
 
-	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
+	const quint64 generation(++m_rulesGeneration);
 
-	QTextStream stream(&file);
-	stream.setCodec("UTF-8");
-	stream.readLine(); // header
+	m_rulesSetMutex.unlock();
 
-	m_root = new Node();
+	if (!canKeepPrevious)
+	{
+		ContentFiltersManager::clearCache();
+	}
 
-	while (!stream.atEnd())
+	const QFuture<LoadingResult> future(QtConcurrent::run([=]()
 	{
-		parseRuleLine(stream.readLine());
+		return parseRules(profileSummary, path, cachePath, generation);
+	}));
+
+	// Finished loads hold their rules sets in their results, so keep only those still running to let superseded rules sets be released
+	const QList<QFuture<LoadingResult> > futures(m_loadingSynchronizer.futures());
+
+	m_loadingSynchronizer.clearFutures();
+
+	for (int i = 0; i < futures.count(); ++i)
+	{
+		if (!futures.at(i).isFinished())
+		{
+			m_loadingSynchronizer.addFuture(futures.at(i));
+		}
 	}
 
-	file.close();
+	m_loadingSynchronizer.addFuture(future);
+	m_loadingWatcher.setFuture(future);
 
 	return true;
 }
 
+AdblockContentFiltersProfile::LoadingResult AdblockContentFiltersProfile::parseRules(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath, quint64 generation)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	LoadingResult result;
+	result.rulesSet = loadCache(profileSummary, path, cachePath);
+	result.isCached = !result.rulesSet.isNull();
+
+	if (!result.isCached)
+	{
+		QFile file(path);
+		file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+		QTextStream stream(&file);
+		stream.setCodec("UTF-8");
+		stream.readLine(); // header
+
+		TrieBuilder builder;
+		QSharedPointer<RulesSet> rulesSet(new RulesSet());
+
+		while (!stream.atEnd())
+		{
+			parseRuleLine(stream.readLine(), profileSummary, &builder, rulesSet.data());
+		}
+
+		file.close();
+
+		compileTrie(builder, rulesSet.data());
+		compileAutomaton(rulesSet.data());
+
+		result.rulesSet = rulesSet;
+		result.loadingTime = timer.elapsed();
+		result.errorString = saveCache(*rulesSet, profileSummary, path, cachePath);
+	}
+	else
+	{
+		result.loadingTime = timer.elapsed();
+	}
+
+	if (!setRulesSet(result.rulesSet, generation))
+	{
+		return {};
+	}
+
+	ContentFiltersManager::clearCache();
+
+	return result;
+}
+
 bool AdblockContentFiltersProfile::update(const QUrl &url)
 {
 	if (m_dataFetchJob || thread() != QThread::currentThread())
@@ -1048,6 +1680,8 @@ bool AdblockContentFiltersProfile::remove()
 		m_dataFetchJob = nullptr;
 	}
 
+	QFile::remove(getCachePath());
+
 	if (QFile::exists(path))
 	{
 		return QFile::remove(path);
@@ -1081,6 +1715,20 @@ bool AdblockContentFiltersProfile::isFraud(const QUrl &url)
 	return false;
 }
 
+bool AdblockContentFiltersProfile::setRulesSet(const QSharedPointer<const RulesSet> &rulesSet, quint64 generation)
+{
+	QMutexLocker locker(&m_rulesSetMutex);
+
+	if (generation != m_rulesGeneration)
+	{
+		return false;
+	}
+
+	m_rulesSet = rulesSet;
+
+	return true;
+}
+
 bool AdblockContentFiltersProfile::isUpdating() const
 {
 	return (m_dataFetchJob != nullptr);
@@ -24,7 +24,14 @@
 
 #include "ContentFiltersManager.h"
 
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QFutureSynchronizer>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
 
 namespace Otter
 {
@@ -44,6 +51,12 @@ public:
 		WildcardRule
 	};
 
+	enum MatchingEngine
+	{
+		AutomatonEngine = 0,
+		TrieEngine
+	};
+
 	struct HeaderInformation final
 	{
 		QString title;
@@ -58,6 +71,7 @@ public:
 	};
 
 	explicit AdblockContentFiltersProfile(const ProfileSummary &profileSummary, const QStringList &languages, ProfileFlags flags, QObject *parent = nullptr);
+	~AdblockContentFiltersProfile();
 
 	void clear() override;
 	void setProfileSummary(const ProfileSummary &profileSummary) override;
@@ -105,6 +119,12 @@ protected:
 
 	Q_DECLARE_FLAGS(RuleOptions, RuleOption)
 
+	enum CacheFormat : quint32
+	{
+		CacheSignature = 0x4F434643,
+		CacheVersion = 5
+	};
+
 	enum RuleMatch
 	{
 		ContainsMatch = 0,
@@ -127,9 +147,76 @@ protected:
 			bool needsDomainCheck = false;
 		};
 
+		quint32 firstChild = 0;
+		quint32 childrenAmount = 0;
+		quint32 firstRule = 0;
+		quint32 rulesAmount = 0;
+		quint32 failureNode = 0;
+		quint32 outputNode = 0;
+		quint32 depth = 0;
 		QChar value = 0;
-		QVarLengthArray<Node*, 1> children;
-		QVarLengthArray<Rule*, 1> rules;
+		bool hasWildcardChildren = false;
+		quint8 reserved = 0;
+	};
+
+	struct TrieBuilder final
+	{
+		struct Entry final
+		{
+			QVarLengthArray<int, 1> children;
+			QVarLengthArray<int, 1> rules;
+			QChar value = 0;
+		};
+
+		QVector<Entry> entries;
+		QVector<Node::Rule> rules;
+		QHash<QString, QVector<int> > domains;
+		QSet<QString> strings;
+
+		TrieBuilder() : entries(1)
+		{
+		}
+	};
+
+	struct NodesPool final
+	{
+		QVector<Node> storage;
+		QSharedPointer<QFile> file;
+		const Node *data = nullptr;
+		int amount = 0;
+
+		const Node& at(int index) const
+		{
+			return data[index];
+		}
+
+		const Node* constBegin() const
+		{
+			return data;
+		}
+
+		int count() const
+		{
+			return amount;
+		}
+	};
+
+	struct RulesSet final
+	{
+		NodesPool nodes;
+		QVector<Node::Rule> rules;
+		QHash<QString, QVector<int> > domainRules;
+		QStringList cosmeticFiltersRules;
+		QMultiHash<QString, QString> cosmeticFiltersDomainRules;
+		QMultiHash<QString, QString> cosmeticFiltersDomainExceptions;
+	};
+
+	struct LoadingResult final
+	{
+		QSharedPointer<const RulesSet> rulesSet;
+		QString errorString;
+		qint64 loadingTime = 0;
+		bool isCached = false;
 	};
 
 	struct Request final
@@ -137,9 +224,10 @@ protected:
 		QString baseHost;
 		QString requestHost;
 		QString requestUrl;
+		QStringList requestSubdomains;
 		NetworkManager::ResourceType resourceType = NetworkManager::OtherType;
 
-		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), resourceType(resourceTypeValue)
+		explicit Request(const QUrl &baseUrlValue, const QUrl &requestUrlValue, NetworkManager::ResourceType resourceTypeValue) : baseHost(baseUrlValue.host()), requestHost(requestUrlValue.host()), requestUrl(requestUrlValue.toString()), requestSubdomains(ContentFiltersManager::createSubdomainList(requestHost)), resourceType(resourceTypeValue)
 		{
 			if (requestUrl.startsWith(QLatin1String("//")))
 			{
@@ -149,34 +237,55 @@ protected:
 	};
 
 	void loadHeader();
-	void parseRuleLine(const QString &rule);
-	void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
-	void deleteNode(Node *node) const;
-	ContentFiltersManager::CheckResult checkUrlSubstring(const Node *node, const QString &subString, QString currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule *rule, const QString &currentRule, const Request &request) const;
-	ContentFiltersManager::CheckResult evaluateNodeRules(const Node *node, const QString &currentRule, const Request &request) const;
-	bool loadRules();
+	static void parseRuleLine(const QString &rule, const ProfileSummary &profileSummary, TrieBuilder *builder, RulesSet *rulesSet);
+	static void parseStyleSheetRule(const QStringList &line, QMultiHash<QString, QString> &list);
+	static void compileTrie(const TrieBuilder &builder, RulesSet *rulesSet);
+	static void compileAutomaton(RulesSet *rulesSet);
+	static QString saveCache(const RulesSet &rulesSet, const ProfileSummary &profileSummary, const QString &path, const QString &cachePath);
+	static QString internString(const QString &string, QSet<QString> &strings);
+	QString getCachePath() const;
+	static QByteArray getRulesChecksum(const QString &path);
+	QSharedPointer<const RulesSet> getRulesSet() const;
+	static QSharedPointer<const RulesSet> loadCache(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath);
+	LoadingResult parseRules(const ProfileSummary &profileSummary, const QString &path, const QString &cachePath, quint64 generation);
+	ContentFiltersManager::CheckResult checkDomainRules(const RulesSet &rulesSet, const Request &request) const;
+	ContentFiltersManager::CheckResult checkUrlAutomaton(const RulesSet &rulesSet, const Request &request) const;
+	ContentFiltersManager::CheckResult checkWildcardChildren(const RulesSet &rulesSet, const Node &node, int position, const QString &currentRule, const Request &request) const;
+	ContentFiltersManager::CheckResult checkUrlSubstring(const RulesSet &rulesSet, int node, int position, QString currentRule, const Request &request) const;
+	ContentFiltersManager::CheckResult checkRuleMatch(const Node::Rule &rule, const QString &currentRule, const Request &request) const;
+	ContentFiltersManager::CheckResult evaluateNodeRules(const RulesSet &rulesSet, const Node &node, const QString &currentRule, const Request &request) const;
+	static int findChild(const RulesSet &rulesSet, const Node &node, QChar value);
 	bool resolveDomainExceptions(const QString &url, const QStringList &ruleList) const;
+	bool setRulesSet(const QSharedPointer<const RulesSet> &rulesSet, quint64 generation);
 
 protected slots:
 	void raiseError(const QString &message, ProfileError error);
 	void handleJobFinished(bool isSuccess);
+	void handleOptionChanged(int identifier, const QVariant &value);
+	void handleRulesLoaded();
+	bool loadRules();
 
 private:
-	Node *m_root;
 	DataFetchJob *m_dataFetchJob;
 	ProfileSummary m_profileSummary;
-	QRegularExpression m_domainExpression;
-	QStringList m_cosmeticFiltersRules;
+	const QRegularExpression m_domainExpression;
+	QSharedPointer<const RulesSet> m_rulesSet;
 	QVector<QLocale::Language> m_languages;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainRules;
-	QMultiHash<QString, QString> m_cosmeticFiltersDomainExceptions;
+	QFutureWatcher<LoadingResult> m_loadingWatcher;
+	QFutureSynchronizer<LoadingResult> m_loadingSynchronizer;
+	mutable QMutex m_rulesSetMutex;
+	quint64 m_rulesGeneration;
 	ProfileError m_error;
 	ProfileFlags m_flags;
+	QAtomicInt m_matchingEngine;
+	QAtomicInt m_isLoadingRequested;
 	bool m_wasLoaded;
 
 	static QHash<QString, RuleOption> m_options;
 	static QHash<NetworkManager::ResourceType, RuleOption> m_resourceTypes;
+
+signals:
+	void rulesLoaded();
 };
 
 }
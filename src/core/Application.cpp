@@ -22,6 +22,7 @@
 #include "AddonsManager.h"
 #include "BookmarksManager.h"
 #include "Console.h"
+#include "ContentFiltersManager.h"
 #include "FeedsManager.h"
 #include "GesturesManager.h"
 #include "HandlersManager.h"
@@ -1446,7 +1447,7 @@ QString Application::createReport(ReportOptions options)
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
 		stream << QLatin1String("History");
-		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json"));
+		stream << SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.dat"));
 		stream.setFieldWidth(0);
 		stream << QLatin1String("\n\t");
 		stream.setFieldWidth(20);
@@ -1456,6 +1457,28 @@ QString Application::createReport(ReportOptions options)
 		stream << QLatin1String("\n\n");
 	}
 
+	if (options.testFlag(EnvironmentReport))
+	{
+		const ContentFiltersManager::CacheStatistics statistics(ContentFiltersManager::getCacheStatistics());
+
+		stream << QLatin1String("Content Blocking:\n\t");
+		stream.setFieldWidth(20);
+		stream << QLatin1String("Cached Results");
+		stream << statistics.amount;
+		stream.setFieldWidth(0);
+		stream << QLatin1String("\n\t");
+		stream.setFieldWidth(20);
+		stream << QLatin1String("Cache Hits");
+		stream << statistics.hits;
+		stream.setFieldWidth(0);
+		stream << QLatin1String("\n\t");
+		stream.setFieldWidth(20);
+		stream << QLatin1String("Cache Misses");
+		stream << statistics.misses;
+		stream.setFieldWidth(0);
+		stream << QLatin1String("\n\n");
+	}
+
 	if (options.testFlag(SettingsReport))
 	{
 		stream << SettingsManager::createReport();
@@ -20,6 +20,7 @@
 
 #include "BookmarksManager.h"
 #include "Application.h"
+#include "HistoryManager.h"
 #include "SessionsManager.h"
 #include "Utils.h"
 
@@ -30,7 +31,9 @@ namespace Otter
 
 BookmarksManager* BookmarksManager::m_instance(nullptr);
 BookmarksModel* BookmarksManager::m_model(nullptr);
+TextSearchIndex BookmarksManager::m_textSearchIndex;
 qulonglong BookmarksManager::m_lastUsedFolder(0);
+bool BookmarksManager::m_isTextSearchIndexed(false);
 
 BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
@@ -72,6 +75,10 @@ void BookmarksManager::ensureInitialized()
 		m_model = new BookmarksModel(SessionsManager::getWritableDataPath(QLatin1String("bookmarks.xbel")), BookmarksModel::BookmarksMode, m_instance);
 
 		connect(m_model, &BookmarksModel::modelModified, m_instance, &BookmarksManager::scheduleSave);
+		connect(m_model, &BookmarksModel::modelReset, m_instance, &BookmarksManager::handleModelReset);
+		connect(m_model, &BookmarksModel::bookmarkAdded, m_instance, &BookmarksManager::handleBookmarkModified);
+		connect(m_model, &BookmarksModel::bookmarkModified, m_instance, &BookmarksManager::handleBookmarkModified);
+		connect(m_model, &BookmarksModel::bookmarkRemoved, m_instance, &BookmarksManager::handleBookmarkRemoved);
 	}
 }
 
@@ -97,6 +104,73 @@ void BookmarksManager::scheduleSave()
 	}
 }
 
+void BookmarksManager::indexBookmark(BookmarksModel::Bookmark *bookmark, bool isRecursive)
+{
+	const quint64 identifier(bookmark->getIdentifier());
+
+	if (identifier > 0)
+	{
+		switch (bookmark->getType())
+		{
+			case BookmarksModel::FeedBookmark:
+			case BookmarksModel::FolderBookmark:
+			case BookmarksModel::TrashBookmark:
+				m_textSearchIndex.addDocument(identifier, bookmark->getTitle() + QLatin1Char(' ') + bookmark->getDescription());
+
+				break;
+			case BookmarksModel::UrlBookmark:
+				m_textSearchIndex.addDocument(identifier, QStringList({bookmark->getTitle(), bookmark->getUrl().toDisplayString(), bookmark->getDescription(), bookmark->getKeyword()}).join(QLatin1Char(' ')));
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (isRecursive)
+	{
+		for (int i = 0; i < bookmark->rowCount(); ++i)
+		{
+			BookmarksModel::Bookmark *childBookmark(bookmark->getChild(i));
+
+			if (childBookmark)
+			{
+				indexBookmark(childBookmark, true);
+			}
+		}
+	}
+}
+
+void BookmarksManager::handleBookmarkModified(BookmarksModel::Bookmark *bookmark)
+{
+	if (m_isTextSearchIndexed && bookmark)
+	{
+		indexBookmark(bookmark);
+	}
+}
+
+void BookmarksManager::handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark)
+{
+	if (!m_isTextSearchIndexed || !bookmark)
+	{
+		return;
+	}
+
+	m_textSearchIndex.removeDocument(bookmark->getIdentifier());
+
+	for (int i = 0; i < bookmark->rowCount(); ++i)
+	{
+		handleBookmarkRemoved(bookmark->getChild(i));
+	}
+}
+
+void BookmarksManager::handleModelReset()
+{
+	m_textSearchIndex.clear();
+
+	m_isTextSearchIndexed = false;
+}
+
 void BookmarksManager::updateVisits(const QUrl &url)
 {
 	ensureInitialized();
@@ -194,11 +268,26 @@ QStringList BookmarksManager::getKeywords()
 	return m_model->getKeywords();
 }
 
-QVector<BookmarksModel::BookmarkMatch> BookmarksManager::findBookmarks(const QString &prefix)
+QVector<BookmarksModel::BookmarkMatch> BookmarksManager::findBookmarks(const QString &prefix, int limit)
+{
+	ensureInitialized();
+
+	return m_model->findBookmarks(prefix, limit, HistoryManager::getFrecencyIndex());
+}
+
+QVector<quint64> BookmarksManager::searchBookmarks(const QString &query)
 {
 	ensureInitialized();
 
-	return m_model->findBookmarks(prefix);
+	if (!m_isTextSearchIndexed)
+	{
+		indexBookmark(m_model->getRootItem(), true);
+		indexBookmark(m_model->getTrashItem(), true);
+
+		m_isTextSearchIndexed = true;
+	}
+
+	return m_textSearchIndex.findDocuments(query);
 }
 
 bool BookmarksManager::hasBookmark(const QUrl &url)
@@ -22,6 +22,7 @@
 #define OTTER_BOOKMARKSMANAGER_H
 
 #include "BookmarksModel.h"
+#include "TextSearchIndex.h"
 
 #include <QtCore/QObject>
 
@@ -44,7 +45,8 @@ public:
 	static BookmarksModel::Bookmark* getBookmark(quint64 identifier);
 	static BookmarksModel::Bookmark* getLastUsedFolder();
 	static QStringList getKeywords();
-	static QVector<BookmarksModel::BookmarkMatch> findBookmarks(const QString &prefix);
+	static QVector<BookmarksModel::BookmarkMatch> findBookmarks(const QString &prefix, int limit = 0);
+	static QVector<quint64> searchBookmarks(const QString &query);
 	static bool hasBookmark(const QUrl &url);
 	static bool hasKeyword(const QString &keyword);
 
@@ -53,16 +55,22 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	static void ensureInitialized();
+	static void indexBookmark(BookmarksModel::Bookmark *bookmark, bool isRecursive = false);
 
 protected slots:
 	void scheduleSave();
+	void handleBookmarkModified(BookmarksModel::Bookmark *bookmark);
+	void handleBookmarkRemoved(BookmarksModel::Bookmark *bookmark);
+	void handleModelReset();
 
 private:
 	int m_saveTimer;
 
 	static BookmarksManager *m_instance;
 	static BookmarksModel *m_model;
+	static TextSearchIndex m_textSearchIndex;
 	static qulonglong m_lastUsedFolder;
+	static bool m_isTextSearchIndexed;
 };
 
 }
@@ -24,14 +24,19 @@
 #include "HistoryManager.h"
 #include "SessionsManager.h"
 #include "ThemesManager.h"
+#include "UrlInterner.h"
 #include "Utils.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtCore/QMimeData>
 #include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 #include <QtWidgets/QMessageBox>
 
+#include <algorithm>
+#include <limits>
+
 namespace Otter
 {
 
@@ -858,15 +863,18 @@ void BookmarksModel::removeBookmarkUrl(Bookmark *bookmark)
 			break;
 		case UrlBookmark:
 			{
-				const QUrl url(Utils::normalizeUrl(bookmark->data(UrlRole).toUrl()));
+				const quint32 urlIdentifier(UrlInterner::findUrl(bookmark->data(UrlRole).toUrl()));
 
-				if (!url.isEmpty() && m_urls.contains(url))
+				if (urlIdentifier > 0 && m_urls.contains(urlIdentifier))
 				{
-					m_urls[url].removeAll(bookmark);
+					m_urls[urlIdentifier].removeAll(bookmark);
 
-					if (m_urls[url].isEmpty())
+					if (m_urls[urlIdentifier].isEmpty())
 					{
-						m_urls.remove(url);
+						m_urls.remove(urlIdentifier);
+						m_urlsIndex.removeUrl(UrlInterner::getUrl(urlIdentifier));
+
+						UrlInterner::releaseUrl(urlIdentifier);
 					}
 				}
 			}
@@ -889,16 +897,19 @@ void BookmarksModel::readdBookmarkUrl(Bookmark *bookmark)
 		case FeedBookmark:
 		case UrlBookmark:
 			{
-				const QUrl url(Utils::normalizeUrl(bookmark->data(UrlRole).toUrl()));
+				const quint32 urlIdentifier(UrlInterner::internUrl(bookmark->data(UrlRole).toUrl()));
 
-				if (!url.isEmpty())
+				if (urlIdentifier > 0)
 				{
-					if (!m_urls.contains(url))
+					if (!m_urls.contains(urlIdentifier))
 					{
-						m_urls[url] = {};
+						m_urls[urlIdentifier] = {};
+						m_urlsIndex.addUrl(UrlInterner::getUrl(urlIdentifier));
+
+						UrlInterner::retainUrl(urlIdentifier);
 					}
 
-					m_urls[url].append(bookmark);
+					m_urls[urlIdentifier].append(bookmark);
 				}
 			}
 
@@ -1015,24 +1026,38 @@ void BookmarksModel::handleKeywordChanged(Bookmark *bookmark, const QString &new
 
 void BookmarksModel::handleUrlChanged(Bookmark *bookmark, const QUrl &newUrl, const QUrl &oldUrl)
 {
-	if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
+	const quint32 oldUrlIdentifier(UrlInterner::findUrl(oldUrl));
+	const quint32 newUrlIdentifier(UrlInterner::internUrl(newUrl));
+
+	if (oldUrlIdentifier == newUrlIdentifier && m_urls.value(oldUrlIdentifier).contains(bookmark))
+	{
+		return;
+	}
+
+	if (oldUrlIdentifier > 0 && m_urls.contains(oldUrlIdentifier))
 	{
-		m_urls[oldUrl].removeAll(bookmark);
+		m_urls[oldUrlIdentifier].removeAll(bookmark);
 
-		if (m_urls[oldUrl].isEmpty())
+		if (m_urls[oldUrlIdentifier].isEmpty())
 		{
-			m_urls.remove(oldUrl);
+			m_urls.remove(oldUrlIdentifier);
+			m_urlsIndex.removeUrl(UrlInterner::getUrl(oldUrlIdentifier));
+
+			UrlInterner::releaseUrl(oldUrlIdentifier);
 		}
 	}
 
-	if (!newUrl.isEmpty())
+	if (newUrlIdentifier > 0)
 	{
-		if (!m_urls.contains(newUrl))
+		if (!m_urls.contains(newUrlIdentifier))
 		{
-			m_urls[newUrl] = {};
+			m_urls[newUrlIdentifier] = {};
+			m_urlsIndex.addUrl(UrlInterner::getUrl(newUrlIdentifier));
+
+			UrlInterner::retainUrl(newUrlIdentifier);
 		}
 
-		m_urls[newUrl].append(bookmark);
+		m_urls[newUrlIdentifier].append(bookmark);
 	}
 }
 
@@ -1091,7 +1116,7 @@ BookmarksModel::Bookmark* BookmarksModel::addBookmark(BookmarkType type, const Q
 
 			if (!url.isEmpty())
 			{
-				handleUrlChanged(bookmark, Utils::normalizeUrl(url));
+				handleUrlChanged(bookmark, url);
 			}
 
 			if (type == UrlBookmark)
@@ -1260,12 +1285,11 @@ QStringList BookmarksModel::getKeywords() const
 	return m_keywords.keys();
 }
 
-QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix) const
+QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QString &prefix, int limit, const FrecencyIndex *frecencyIndex) const
 {
-	QVector<Bookmark*> matchedBookmarks;
-	QVector<BookmarkMatch> allMatches;
-	QVector<BookmarkMatch> currentMatches;
-	QMultiMap<QDateTime, BookmarkMatch> matchesMap;
+	QSet<Bookmark*> matchedBookmarks;
+	QVector<BookmarkMatch> matches;
+	QVector<QPair<QUrl, Bookmark*> > urlMatches;
 	QHash<QString, Bookmark*>::const_iterator keywordsIterator;
 
 	for (keywordsIterator = m_keywords.constBegin(); keywordsIterator != m_keywords.constEnd(); ++keywordsIterator)
@@ -1276,56 +1300,87 @@ QVector<BookmarksModel::BookmarkMatch> BookmarksModel::findBookmarks(const QStri
 			match.bookmark = keywordsIterator.value();
 			match.match = keywordsIterator.key();
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+			matches.append(match);
 
-			matchedBookmarks.append(match.bookmark);
+			matchedBookmarks.insert(match.bookmark);
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
+	std::stable_sort(matches.begin(), matches.end(), [&](const BookmarkMatch &first, const BookmarkMatch &second)
+	{
+		return (first.bookmark->getTimeVisited() > second.bookmark->getTimeVisited());
+	});
+
+	if (limit > 0 && matches.count() >= limit)
+	{
+		matches.resize(limit);
+
+		return matches;
+	}
 
-	matchesMap.clear();
+	const QVector<QUrl> urls(m_urlsIndex.findUrls(prefix));
 
-	allMatches.reserve(currentMatches.count());
+	urlMatches.reserve(urls.count());
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = 0; i < urls.count(); ++i)
 	{
-		allMatches.append(currentMatches.at(i));
+		Bookmark *bookmark(m_urls.value(UrlInterner::findUrl(urls.at(i))).value(0));
+
+		if (bookmark && !matchedBookmarks.contains(bookmark))
+		{
+			urlMatches.append({urls.at(i), bookmark});
+
+			matchedBookmarks.insert(bookmark);
+		}
 	}
 
-	QHash<QUrl, QVector<Bookmark*> >::const_iterator urlsIterator;
+	const int amount((limit > 0) ? qMin(urlMatches.count(), (limit - matches.count())) : urlMatches.count());
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	if (frecencyIndex)
 	{
-		if (urlsIterator.value().isEmpty() || matchedBookmarks.contains(urlsIterator.value().value(0)))
+		QVector<QUrl> candidateUrls;
+		QHash<QUrl, Bookmark*> candidateBookmarks;
+		candidateUrls.reserve(urlMatches.count());
+		candidateBookmarks.reserve(urlMatches.count());
+
+		for (int i = 0; i < urlMatches.count(); ++i)
 		{
-			continue;
+			candidateUrls.append(urlMatches.at(i).first);
+			candidateBookmarks[urlMatches.at(i).first] = urlMatches.at(i).second;
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
-
-		if (!result.isEmpty())
+		const QVector<QUrl> selectedUrls(frecencyIndex->selectUrls(candidateUrls, amount, [&](const QUrl &url)
 		{
-			BookmarkMatch match;
-			match.bookmark = urlsIterator.value().value(0);
-			match.match = result;
+			const Bookmark *bookmark(candidateBookmarks.value(url));
 
-			matchesMap.insert(match.bookmark->getTimeVisited(), match);
+			return ((bookmark && bookmark->getVisits() > 0) ? FrecencyIndex::createRank(bookmark->getTimeVisited(), FrecencyIndex::BookmarkVisit, bookmark->getVisits()) : -std::numeric_limits<double>::infinity());
+		}));
 
-			matchedBookmarks.append(match.bookmark);
+		for (int i = 0; i < selectedUrls.count(); ++i)
+		{
+			urlMatches[i] = {selectedUrls.at(i), candidateBookmarks.value(selectedUrls.at(i))};
 		}
 	}
+	else
+	{
+		std::partial_sort(urlMatches.begin(), (urlMatches.begin() + amount), urlMatches.end(), [&](const QPair<QUrl, Bookmark*> &first, const QPair<QUrl, Bookmark*> &second)
+		{
+			return (first.second->getTimeVisited() > second.second->getTimeVisited());
+		});
+	}
 
-	currentMatches = matchesMap.values().toVector();
-
-	matchesMap.clear();
+	matches.reserve(matches.count() + amount);
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = 0; i < amount; ++i)
 	{
-		allMatches.append(currentMatches.at(i));
+		BookmarkMatch match;
+		match.bookmark = urlMatches.at(i).second;
+		match.match = Utils::matchUrl(urlMatches.at(i).first, prefix);
+
+		matches.append(match);
 	}
 
-	return allMatches;
+	return matches;
 }
 
 QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, QStandardItem *branch) const
@@ -1368,20 +1423,7 @@ QVector<BookmarksModel::Bookmark*> BookmarksModel::findUrls(const QUrl &url, QSt
 
 QVector<BookmarksModel::Bookmark*> BookmarksModel::getBookmarks(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
-	QVector<BookmarksModel::Bookmark*> bookmarks;
-
-	if (m_urls.contains(url))
-	{
-		bookmarks = m_urls[url];
-	}
-
-	if (url != normalizedUrl && m_urls.contains(normalizedUrl))
-	{
-		bookmarks.append(m_urls[normalizedUrl]);
-	}
-
-	return bookmarks;
+	return m_urls.value(UrlInterner::findUrl(url));
 }
 
 BookmarksModel::FormatMode BookmarksModel::getFormatMode() const
@@ -1549,7 +1591,7 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 		case UrlRole:
 			if (value.toUrl() != index.data(UrlRole).toUrl())
 			{
-				handleUrlChanged(bookmark, Utils::normalizeUrl(value.toUrl()), Utils::normalizeUrl(index.data(UrlRole).toUrl()));
+				handleUrlChanged(bookmark, value.toUrl(), index.data(UrlRole).toUrl());
 			}
 
 			break;
@@ -1584,7 +1626,7 @@ bool BookmarksModel::setData(const QModelIndex &index, const QVariant &value, in
 
 bool BookmarksModel::hasBookmark(const QUrl &url) const
 {
-	return (m_urls.contains(url) || m_urls.contains(Utils::normalizeUrl(url)));
+	return m_urls.contains(UrlInterner::findUrl(url));
 }
 
 bool BookmarksModel::hasFeed(const QUrl &url) const
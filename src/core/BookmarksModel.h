@@ -21,6 +21,9 @@
 #ifndef OTTER_BOOKMARKSMODEL_H
 #define OTTER_BOOKMARKSMODEL_H
 
+#include "FrecencyIndex.h"
+#include "UrlPrefixIndex.h"
+
 #include <QtCore/QUrl>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -124,7 +127,7 @@ public:
 	QMimeData* mimeData(const QModelIndexList &indexes) const override;
 	QStringList mimeTypes() const override;
 	QStringList getKeywords() const;
-	QVector<BookmarkMatch> findBookmarks(const QString &prefix) const;
+	QVector<BookmarkMatch> findBookmarks(const QString &prefix, int limit = 0, const FrecencyIndex *frecencyIndex = nullptr) const;
 	QVector<Bookmark*> findUrls(const QUrl &url, QStandardItem *branch = nullptr) const;
 	QVector<Bookmark*> getBookmarks(const QUrl &url) const;
 	FormatMode getFormatMode() const;
@@ -160,7 +163,8 @@ private:
 	Bookmark *m_importTargetItem;
 	QHash<Bookmark*, QPair<QModelIndex, int> > m_trash;
 	QHash<QUrl, QVector<Bookmark*> > m_feeds;
-	QHash<QUrl, QVector<Bookmark*> > m_urls;
+	UrlPrefixIndex m_urlsIndex;
+	QHash<quint32, QVector<Bookmark*> > m_urls;
 	QHash<QString, Bookmark*> m_keywords;
 	QMap<quint64, Bookmark*> m_identifiers;
 	FormatMode m_mode;
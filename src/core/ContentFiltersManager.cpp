@@ -29,6 +29,8 @@
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
 #include <QtCore/QTimer>
 
 namespace Otter
@@ -37,6 +39,14 @@ namespace Otter
 ContentFiltersManager* ContentFiltersManager::m_instance(nullptr);
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_contentBlockingProfiles;
 QVector<ContentFiltersProfile*> ContentFiltersManager::m_fraudCheckingProfiles;
+QCache<QString, ContentFiltersManager::CheckResult> ContentFiltersManager::m_cache(5000);
+QCache<QString, QString> ContentFiltersManager::m_styleSheetsCache(100);
+QHash<QString, QString> ContentFiltersManager::m_genericStyleSheets;
+quint64 ContentFiltersManager::m_cacheHits(0);
+quint64 ContentFiltersManager::m_cacheMisses(0);
+quint64 ContentFiltersManager::m_cacheGeneration(0);
+QMutex ContentFiltersManager::m_cacheMutex;
+QReadWriteLock ContentFiltersManager::m_profilesLock;
 
 ContentFiltersManager::ContentFiltersManager(QObject *parent) : QObject(parent),
 	m_saveTimer(0)
@@ -91,7 +101,9 @@ void ContentFiltersManager::initialize()
 
 	profiles.sort();
 
+	m_profilesLock.lockForWrite();
 	m_contentBlockingProfiles.reserve(profiles.count());
+	m_profilesLock.unlock();
 
 	QJsonObject localMainObject(JsonSettings(SessionsManager::getWritableDataPath(QLatin1String("contentBlocking.json"))).object());
 	const QHash<QString, ContentFiltersProfile::ProfileCategory> categoryTitles({{QLatin1String("advertisements"), ContentFiltersProfile::AdvertisementsCategory}, {QLatin1String("annoyance"), ContentFiltersProfile::AnnoyanceCategory}, {QLatin1String("privacy"), ContentFiltersProfile::PrivacyCategory}, {QLatin1String("social"), ContentFiltersProfile::SocialCategory}, {QLatin1String("regional"), ContentFiltersProfile::RegionalCategory}, {QLatin1String("other"), ContentFiltersProfile::OtherCategory}});
@@ -168,16 +180,22 @@ void ContentFiltersManager::initialize()
 
 		ContentFiltersProfile *profile(new AdblockContentFiltersProfile(profileSummary, languages, flags, m_instance));
 
+		m_profilesLock.lockForWrite();
 		m_contentBlockingProfiles.append(profile);
+		m_profilesLock.unlock();
 
 		connect(profile, &ContentFiltersProfile::profileModified, profile, [=]()
 		{
+			clearCache();
+
 			m_instance->scheduleSave();
 
 			emit m_instance->profileModified(profile->getName());
 		});
 	}
 
+	QWriteLocker locker(&m_profilesLock);
+
 	m_contentBlockingProfiles.squeeze();
 }
 
@@ -298,6 +316,8 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 
 	bool isReplacing(false);
 
+	m_profilesLock.lockForWrite();
+
 	for (int i = 0; i < m_contentBlockingProfiles.count(); ++i)
 	{
 		if (m_contentBlockingProfiles.at(i)->getName() == profile->getName())
@@ -316,10 +336,15 @@ void ContentFiltersManager::addProfile(ContentFiltersProfile *profile)
 		m_contentBlockingProfiles.append(profile);
 	}
 
+	m_profilesLock.unlock();
+
+	clearCache();
+
 	m_instance->scheduleSave();
 
 	emit m_instance->profileAdded(profile->getName());
 
+	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::clearCache);
 	connect(profile, &ContentFiltersProfile::profileModified, m_instance, &ContentFiltersManager::scheduleSave);
 }
 
@@ -352,13 +377,28 @@ void ContentFiltersManager::removeProfile(ContentFiltersProfile *profile, bool r
 	localSettings.setObject(localMainObject);
 	localSettings.save();
 
+	m_profilesLock.lockForWrite();
 	m_contentBlockingProfiles.removeAll(profile);
+	m_profilesLock.unlock();
+
+	clearCache();
 
 	profile->deleteLater();
 
 	emit m_instance->profileRemoved(name);
 }
 
+void ContentFiltersManager::clearCache()
+{
+	QMutexLocker locker(&m_cacheMutex);
+
+	m_cache.clear();
+	m_styleSheetsCache.clear();
+	m_genericStyleSheets.clear();
+
+	++m_cacheGeneration;
+}
+
 ContentFiltersManager* ContentFiltersManager::getInstance()
 {
 	return m_instance;
@@ -414,9 +454,43 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 		return {};
 	}
 
+	QString key;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		key.append(QString::number(profiles.at(i)) + QLatin1Char(','));
+	}
+
+	key.append(QLatin1Char('|') + baseUrl.host() + QLatin1Char('|') + QString::number(resourceType) + QLatin1Char('|') + requestUrl.toString());
+
+	quint64 generation(0);
+
+	m_cacheMutex.lock();
+
+	const CheckResult *cachedResult(m_cache.object(key));
+
+	if (cachedResult)
+	{
+		const CheckResult result(*cachedResult);
+
+		++m_cacheHits;
+
+		m_cacheMutex.unlock();
+
+		return result;
+	}
+
+	++m_cacheMisses;
+
+	generation = m_cacheGeneration;
+
+	m_cacheMutex.unlock();
+
 	CheckResult result;
 	result.isFraud = ((resourceType == NetworkManager::MainFrameType || resourceType == NetworkManager::SubFrameType) ? isFraud(requestUrl) : false);
 
+	m_profilesLock.lockForRead();
+
 	for (int i = 0; i < profiles.count(); ++i)
 	{
 		if (profiles.at(i) >= 0 && profiles.at(i) < m_contentBlockingProfiles.count())
@@ -431,15 +505,26 @@ ContentFiltersManager::CheckResult ContentFiltersManager::checkUrl(const QVector
 			}
 			else if (currentResult.isException)
 			{
-				return currentResult;
+				result = currentResult;
+
+				break;
 			}
 		}
 	}
 
+	m_profilesLock.unlock();
+
+	QMutexLocker locker(&m_cacheMutex);
+
+	if (generation == m_cacheGeneration)
+	{
+		m_cache.insert(key, new CheckResult(result));
+	}
+
 	return result;
 }
 
-ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl)
+QString ContentFiltersManager::getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl)
 {
 	if (profiles.isEmpty())
 	{
@@ -453,8 +538,42 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 		return {};
 	}
 
-	CosmeticFiltersResult result;
-	const QStringList domains(createSubdomainList(requestUrl.host()));
+	QString profilesKey;
+
+	for (int i = 0; i < profiles.count(); ++i)
+	{
+		profilesKey.append(QString::number(profiles.at(i)) + QLatin1Char(','));
+	}
+
+	const QString host(requestUrl.host());
+	const QString key(profilesKey + QLatin1Char('|') + QString::number(mode) + QLatin1Char('|') + host);
+	QString genericStyleSheet;
+	quint64 generation(0);
+
+	m_cacheMutex.lock();
+
+	const QString *cachedStyleSheet(m_styleSheetsCache.object(key));
+
+	if (cachedStyleSheet)
+	{
+		const QString styleSheet(*cachedStyleSheet);
+
+		m_cacheMutex.unlock();
+
+		return styleSheet;
+	}
+
+	generation = m_cacheGeneration;
+	genericStyleSheet = m_genericStyleSheets.value(profilesKey);
+
+	m_cacheMutex.unlock();
+
+	const QStringList domains(createSubdomainList(host));
+	QStringList genericRules;
+	QStringList domainRules;
+	QSet<QString> exceptions;
+
+	m_profilesLock.lockForRead();
 
 	for (int i = 0; i < profiles.count(); ++i)
 	{
@@ -462,14 +581,97 @@ ContentFiltersManager::CosmeticFiltersResult ContentFiltersManager::getCosmeticF
 
 		if (index >= 0 && index < m_contentBlockingProfiles.count())
 		{
-			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, (mode == DomainOnlyFilters)));
+			const CosmeticFiltersResult profileResult(m_contentBlockingProfiles.at(index)->getCosmeticFilters(domains, true));
 
-			result.rules.append(profileResult.rules);
-			result.exceptions.append(profileResult.exceptions);
+			domainRules.append(profileResult.rules);
+
+			for (int j = 0; j < profileResult.exceptions.count(); ++j)
+			{
+				exceptions.insert(profileResult.exceptions.at(j));
+			}
 		}
 	}
 
-	return result;
+	if (mode == AllFilters && (genericStyleSheet.isNull() || !exceptions.isEmpty()))
+	{
+		for (int i = 0; i < profiles.count(); ++i)
+		{
+			const int index(profiles.at(i));
+
+			if (index >= 0 && index < m_contentBlockingProfiles.count())
+			{
+				genericRules.append(m_contentBlockingProfiles.at(index)->getCosmeticFilters({}, false).rules);
+			}
+		}
+	}
+
+	m_profilesLock.unlock();
+
+	QString styleSheet;
+
+	if (mode == AllFilters)
+	{
+		if (exceptions.isEmpty())
+		{
+			if (genericStyleSheet.isNull())
+			{
+				genericStyleSheet = createCosmeticFiltersStyleSheet(genericRules, exceptions);
+			}
+
+			styleSheet = genericStyleSheet;
+		}
+		else
+		{
+			styleSheet = createCosmeticFiltersStyleSheet(genericRules, exceptions);
+		}
+	}
+
+	styleSheet.append(createCosmeticFiltersStyleSheet(domainRules, exceptions));
+
+	QMutexLocker locker(&m_cacheMutex);
+
+	if (generation == m_cacheGeneration)
+	{
+		if (mode == AllFilters && exceptions.isEmpty())
+		{
+			m_genericStyleSheets[profilesKey] = genericStyleSheet;
+		}
+
+		m_styleSheetsCache.insert(key, new QString(styleSheet));
+	}
+
+	return styleSheet;
+}
+
+ContentFiltersManager::CacheStatistics ContentFiltersManager::getCacheStatistics()
+{
+	QMutexLocker locker(&m_cacheMutex);
+	CacheStatistics statistics;
+	statistics.hits = m_cacheHits;
+	statistics.misses = m_cacheMisses;
+	statistics.amount = m_cache.count();
+
+	return statistics;
+}
+
+QString ContentFiltersManager::createCosmeticFiltersStyleSheet(const QStringList &rules, const QSet<QString> &exceptions)
+{
+	QString styleSheet;
+	QSet<QString> selectors;
+
+	for (int i = 0; i < rules.count(); ++i)
+	{
+		const QString &selector(rules.at(i));
+
+		if (!exceptions.contains(selector) && !selectors.contains(selector))
+		{
+			selectors.insert(selector);
+
+			styleSheet.append(selector + QLatin1String(" {display: none !important;}\n"));
+		}
+	}
+
+	return styleSheet;
 }
 
 QStringList ContentFiltersManager::createSubdomainList(const QString &domain)
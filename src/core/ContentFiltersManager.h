@@ -23,6 +23,10 @@
 
 #include "NetworkManager.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -58,16 +62,25 @@ public:
 		QStringList exceptions;
 	};
 
+	struct CacheStatistics final
+	{
+		quint64 hits = 0;
+		quint64 misses = 0;
+		int amount = 0;
+	};
+
 	static void createInstance();
 	static void initialize();
 	static void addProfile(ContentFiltersProfile *profile);
 	static void removeProfile(ContentFiltersProfile *profile, bool removeFile = false);
+	static void clearCache();
 	static ContentFiltersManager* getInstance();
 	static ContentFiltersProfile* getProfile(const QString &profile);
 	static ContentFiltersProfile* getProfile(const QUrl &url);
 	static ContentFiltersProfile* getProfile(int identifier);
 	static CheckResult checkUrl(const QVector<int> &profiles, const QUrl &baseUrl, const QUrl &requestUrl, NetworkManager::ResourceType resourceType);
-	static CosmeticFiltersResult getCosmeticFilters(const QVector<int> &profiles, const QUrl &requestUrl);
+	static QString getCosmeticFiltersStyleSheet(const QVector<int> &profiles, const QUrl &requestUrl);
+	static CacheStatistics getCacheStatistics();
 	static QStringList createSubdomainList(const QString &domain);
 	static QStringList getProfileNames();
 	static QVector<ContentFiltersProfile*> getContentBlockingProfiles();
@@ -80,6 +93,7 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void save();
+	static QString createCosmeticFiltersStyleSheet(const QStringList &rules, const QSet<QString> &exceptions);
 
 protected slots:
 	void scheduleSave();
@@ -90,6 +104,14 @@ private:
 	static ContentFiltersManager *m_instance;
 	static QVector<ContentFiltersProfile*> m_contentBlockingProfiles;
 	static QVector<ContentFiltersProfile*> m_fraudCheckingProfiles;
+	static QCache<QString, CheckResult> m_cache;
+	static QCache<QString, QString> m_styleSheetsCache;
+	static QHash<QString, QString> m_genericStyleSheets;
+	static quint64 m_cacheHits;
+	static quint64 m_cacheMisses;
+	static quint64 m_cacheGeneration;
+	static QMutex m_cacheMutex;
+	static QReadWriteLock m_profilesLock;
 
 signals:
 	void profileAdded(const QString &profile);
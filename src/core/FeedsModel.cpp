@@ -23,6 +23,7 @@
 #include "FeedsManager.h"
 #include "SessionsManager.h"
 #include "ThemesManager.h"
+#include "UrlInterner.h"
 #include "Utils.h"
 
 #include <QtCore/QCoreApplication>
@@ -555,15 +556,17 @@ void FeedsModel::removeEntryUrl(Entry *entry)
 	{
 		case FeedEntry:
 			{
-				const QUrl url(Utils::normalizeUrl(entry->data(UrlRole).toUrl()));
+				const quint32 urlIdentifier(UrlInterner::findUrl(entry->data(UrlRole).toUrl()));
 
-				if (!url.isEmpty() && m_urls.contains(url))
+				if (urlIdentifier > 0 && m_urls.contains(urlIdentifier))
 				{
-					m_urls[url].removeAll(entry);
+					m_urls[urlIdentifier].removeAll(entry);
 
-					if (m_urls[url].isEmpty())
+					if (m_urls[urlIdentifier].isEmpty())
 					{
-						m_urls.remove(url);
+						m_urls.remove(urlIdentifier);
+
+						UrlInterner::releaseUrl(urlIdentifier);
 					}
 				}
 			}
@@ -592,16 +595,18 @@ void FeedsModel::readdEntryUrl(Entry *entry)
 	{
 		case FeedEntry:
 			{
-				const QUrl url(Utils::normalizeUrl(entry->data(UrlRole).toUrl()));
+				const quint32 urlIdentifier(UrlInterner::internUrl(entry->data(UrlRole).toUrl()));
 
-				if (!url.isEmpty())
+				if (urlIdentifier > 0)
 				{
-					if (!m_urls.contains(url))
+					if (!m_urls.contains(urlIdentifier))
 					{
-						m_urls[url] = {};
+						m_urls[urlIdentifier] = {};
+
+						UrlInterner::retainUrl(urlIdentifier);
 					}
 
-					m_urls[url].append(entry);
+					m_urls[urlIdentifier].append(entry);
 				}
 			}
 
@@ -642,24 +647,36 @@ void FeedsModel::createIdentifier(FeedsModel::Entry *entry)
 
 void FeedsModel::handleUrlChanged(Entry *entry, const QUrl &newUrl, const QUrl &oldUrl)
 {
-	if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
+	const quint32 oldUrlIdentifier(UrlInterner::findUrl(oldUrl));
+	const quint32 newUrlIdentifier(UrlInterner::internUrl(newUrl));
+
+	if (oldUrlIdentifier == newUrlIdentifier && m_urls.value(oldUrlIdentifier).contains(entry))
+	{
+		return;
+	}
+
+	if (oldUrlIdentifier > 0 && m_urls.contains(oldUrlIdentifier))
 	{
-		m_urls[oldUrl].removeAll(entry);
+		m_urls[oldUrlIdentifier].removeAll(entry);
 
-		if (m_urls[oldUrl].isEmpty())
+		if (m_urls[oldUrlIdentifier].isEmpty())
 		{
-			m_urls.remove(oldUrl);
+			m_urls.remove(oldUrlIdentifier);
+
+			UrlInterner::releaseUrl(oldUrlIdentifier);
 		}
 	}
 
-	if (!newUrl.isEmpty())
+	if (newUrlIdentifier > 0)
 	{
-		if (!m_urls.contains(newUrl))
+		if (!m_urls.contains(newUrlIdentifier))
 		{
-			m_urls[newUrl] = {};
+			m_urls[newUrlIdentifier] = {};
+
+			UrlInterner::retainUrl(newUrlIdentifier);
 		}
 
-		m_urls[newUrl].append(entry);
+		m_urls[newUrlIdentifier].append(entry);
 	}
 }
 
@@ -814,20 +831,7 @@ QStringList FeedsModel::mimeTypes() const
 
 QVector<FeedsModel::Entry*> FeedsModel::getEntries(const QUrl &url) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
-	QVector<FeedsModel::Entry*> entries;
-
-	if (m_urls.contains(url))
-	{
-		entries = m_urls[url];
-	}
-
-	if (url != normalizedUrl && m_urls.contains(normalizedUrl))
-	{
-		entries.append(m_urls[normalizedUrl]);
-	}
-
-	return entries;
+	return m_urls.value(UrlInterner::findUrl(url));
 }
 
 bool FeedsModel::moveEntry(Entry *entry, Entry *newParent, int newRow)
@@ -975,7 +979,7 @@ bool FeedsModel::setData(const QModelIndex &index, const QVariant &value, int ro
 
 	if (role == UrlRole && value.toUrl() != index.data(UrlRole).toUrl())
 	{
-		handleUrlChanged(entry, Utils::normalizeUrl(value.toUrl()), Utils::normalizeUrl(index.data(UrlRole).toUrl()));
+		handleUrlChanged(entry, value.toUrl(), index.data(UrlRole).toUrl());
 	}
 
 	entry->setData(value, role);
@@ -1000,7 +1004,7 @@ bool FeedsModel::setData(const QModelIndex &index, const QVariant &value, int ro
 
 bool FeedsModel::hasFeed(const QUrl &url) const
 {
-	return (m_urls.contains(url) || m_urls.contains(Utils::normalizeUrl(url)));
+	return m_urls.contains(UrlInterner::findUrl(url));
 }
 
 }
@@ -125,7 +125,7 @@ private:
 	Entry *m_trashEntry;
 	Entry *m_importTargetEntry;
 	QHash<Entry*, QPair<QModelIndex, int> > m_trash;
-	QHash<QUrl, QVector<Entry*> > m_urls;
+	QHash<quint32, QVector<Entry*> > m_urls;
 	QMap<quint64, Entry*> m_identifiers;
 
 signals:
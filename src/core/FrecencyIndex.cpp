@@ -0,0 +1,195 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "FrecencyIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Otter
+{
+
+void FrecencyIndex::addVisit(const QUrl &url, const QDateTime &time, VisitType type, int amount)
+{
+	if (url.isEmpty() || amount <= 0)
+	{
+		return;
+	}
+
+	double rank(createRank(time, type, amount));
+	const QHash<QUrl, double>::iterator iterator(m_ranks.find(url));
+
+	if (iterator == m_ranks.end())
+	{
+		m_ranks.insert(url, rank);
+	}
+	else
+	{
+		m_rankedUrls.remove(iterator.value(), url);
+
+		rank = combineRanks(iterator.value(), rank);
+
+		iterator.value() = rank;
+	}
+
+	m_rankedUrls.insert(rank, url);
+}
+
+void FrecencyIndex::removeUrl(const QUrl &url)
+{
+	const QHash<QUrl, double>::iterator iterator(m_ranks.find(url));
+
+	if (iterator != m_ranks.end())
+	{
+		m_rankedUrls.remove(iterator.value(), url);
+		m_ranks.erase(iterator);
+	}
+}
+
+void FrecencyIndex::clear()
+{
+	m_ranks.clear();
+	m_rankedUrls.clear();
+}
+
+QVector<QUrl> FrecencyIndex::findUrls(const std::function<bool(const QUrl &url)> &filter, int limit) const
+{
+	QVector<QUrl> urls;
+
+	if (m_rankedUrls.isEmpty())
+	{
+		return urls;
+	}
+
+	QMultiMap<double, QUrl>::const_iterator iterator(m_rankedUrls.constEnd());
+
+	do
+	{
+		--iterator;
+
+		if (filter(iterator.value()))
+		{
+			urls.append(iterator.value());
+		}
+	}
+	while (iterator != m_rankedUrls.constBegin() && (limit <= 0 || urls.count() < limit));
+
+	return urls;
+}
+
+QVector<QUrl> FrecencyIndex::selectUrls(const QVector<QUrl> &urls, int limit, const std::function<double(const QUrl &url)> &adjustRank) const
+{
+	typedef QPair<double, int> RankedUrl;
+
+	const auto compareUrls([&](const RankedUrl &first, const RankedUrl &second)
+	{
+		return ((first.first == second.first) ? (first.second < second.second) : (first.first > second.first));
+	});
+	const int amount((limit > 0) ? qMin(limit, urls.count()) : urls.count());
+	QVector<RankedUrl> heap;
+	heap.reserve(amount + 1);
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		double rank(getRank(urls.at(i)));
+
+		if (adjustRank)
+		{
+			rank = combineRanks(rank, adjustRank(urls.at(i)));
+		}
+
+		if (heap.count() < amount)
+		{
+			heap.append({rank, i});
+
+			std::push_heap(heap.begin(), heap.end(), compareUrls);
+		}
+		else if (amount > 0 && compareUrls({rank, i}, heap.first()))
+		{
+			std::pop_heap(heap.begin(), heap.end(), compareUrls);
+
+			heap.last() = {rank, i};
+
+			std::push_heap(heap.begin(), heap.end(), compareUrls);
+		}
+	}
+
+	std::sort_heap(heap.begin(), heap.end(), compareUrls);
+
+	QVector<QUrl> selectedUrls;
+	selectedUrls.reserve(heap.count());
+
+	for (int i = 0; i < heap.count(); ++i)
+	{
+		selectedUrls.append(urls.at(heap.at(i).second));
+	}
+
+	return selectedUrls;
+}
+
+double FrecencyIndex::combineRanks(double first, double second)
+{
+	if (std::isinf(first))
+	{
+		return second;
+	}
+
+	if (std::isinf(second))
+	{
+		return first;
+	}
+
+	return (qMax(first, second) + std::log2(1 + std::exp2(-std::fabs(first - second))));
+}
+
+double FrecencyIndex::createRank(const QDateTime &time, VisitType type, int amount)
+{
+	// Decay towards the epoch instead of the current time, so the order of ranks never changes as time passes
+	const double halfLife(30 * 86400);
+	double weight(1);
+
+	switch (type)
+	{
+		case TypedVisit:
+			weight = 2;
+
+			break;
+		case BookmarkVisit:
+			weight = 1.5;
+
+			break;
+		default:
+			break;
+	}
+
+	return (std::log2(weight * amount) + ((time.isValid() ? (time.toMSecsSinceEpoch() / 1000.0) : 0) / halfLife));
+}
+
+double FrecencyIndex::getRank(const QUrl &url) const
+{
+	return m_ranks.value(url, -std::numeric_limits<double>::infinity());
+}
+
+int FrecencyIndex::getUrlsAmount() const
+{
+	return m_ranks.count();
+}
+
+}
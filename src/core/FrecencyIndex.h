@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_FRECENCYINDEX_H
+#define OTTER_FRECENCYINDEX_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+#include <functional>
+
+namespace Otter
+{
+
+class FrecencyIndex final
+{
+public:
+	enum VisitType
+	{
+		LinkVisit = 0,
+		TypedVisit,
+		BookmarkVisit
+	};
+
+	void addVisit(const QUrl &url, const QDateTime &time, VisitType type, int amount = 1);
+	void removeUrl(const QUrl &url);
+	void clear();
+	QVector<QUrl> findUrls(const std::function<bool(const QUrl &url)> &filter, int limit) const;
+	QVector<QUrl> selectUrls(const QVector<QUrl> &urls, int limit, const std::function<double(const QUrl &url)> &adjustRank = nullptr) const;
+	static double combineRanks(double first, double second);
+	static double createRank(const QDateTime &time, VisitType type, int amount = 1);
+	double getRank(const QUrl &url) const;
+	int getUrlsAmount() const;
+
+private:
+	QHash<QUrl, double> m_ranks;
+	QMultiMap<double, QUrl> m_rankedUrls;
+};
+
+}
+
+#endif
@@ -0,0 +1,415 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryJournal.h"
+#include "Console.h"
+#include "SessionsManager.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace Otter
+{
+
+HistoryJournal::HistoryJournal(const QString &path, QObject *parent) : QObject(parent),
+	m_path(path),
+	m_recordsAmount(0),
+	m_pendingRecordsAmount(0),
+	m_compactedRecordsAmount(0),
+	m_compactionRecordsAmount(0),
+	m_isCompacting(false)
+{
+	connect(&m_compactionWatcher, &QFutureWatcher<QString>::finished, this, &HistoryJournal::handleCompactionFinished);
+}
+
+HistoryJournal::~HistoryJournal()
+{
+	if (m_isCompacting)
+	{
+		m_compactionWatcher.waitForFinished();
+
+		handleCompactionFinished();
+	}
+
+	flush();
+}
+
+void HistoryJournal::appendRecord(const Record &record)
+{
+	m_pendingData.append(serializeRecord(record));
+
+	++m_pendingRecordsAmount;
+}
+
+void HistoryJournal::compact(const QVector<Record> &records)
+{
+	if (m_isCompacting || SessionsManager::isReadOnly())
+	{
+		return;
+	}
+
+	flush();
+
+	m_isCompacting = true;
+	m_compactedRecordsAmount = records.count();
+	m_compactionRecordsAmount = 0;
+
+	const QString path(m_path + QLatin1String(".new"));
+
+	m_compactionWatcher.setFuture(QtConcurrent::run([=]()
+	{
+		return writeRecords(path, records);
+	}));
+}
+
+void HistoryJournal::handleCompactionFinished()
+{
+	if (!m_isCompacting)
+	{
+		return;
+	}
+
+	m_isCompacting = false;
+
+	const QString compactedPath(m_path + QLatin1String(".new"));
+	QString errorString(m_compactionWatcher.result());
+
+	if (errorString.isEmpty())
+	{
+		QFile file(compactedPath);
+
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(m_compactionData) != m_compactionData.size())
+		{
+			errorString = file.errorString();
+		}
+
+		file.close();
+	}
+
+	if (errorString.isEmpty() && (!QFile::remove(m_path) || !QFile::rename(compactedPath, m_path)))
+	{
+		errorString = tr("failed to replace journal file");
+	}
+
+	if (errorString.isEmpty())
+	{
+		m_recordsAmount = (m_compactedRecordsAmount + m_compactionRecordsAmount);
+	}
+	else
+	{
+		if (QFile::exists(m_path))
+		{
+			QFile::remove(compactedPath);
+		}
+
+		Console::addMessage(tr("Failed to compact history journal: %1").arg(errorString), Console::OtherCategory, Console::ErrorLevel, m_path);
+	}
+
+	m_compactionData.clear();
+	m_compactedRecordsAmount = 0;
+	m_compactionRecordsAmount = 0;
+}
+
+void HistoryJournal::setRecordsAmount(int amount)
+{
+	m_recordsAmount = amount;
+}
+
+QByteArray HistoryJournal::serializeRecord(const Record &record)
+{
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint8>(record.type) << record.identifier;
+
+	if (record.type == AddRecord || record.type == UpdateRecord)
+	{
+		stream << record.url << record.title << (record.timeVisited.isValid() ? record.timeVisited.toMSecsSinceEpoch() : static_cast<qint64>(-1));
+	}
+
+	QByteArray frame;
+	QDataStream frameStream(&frame, QIODevice::WriteOnly);
+	frameStream.setVersion(QDataStream::Qt_5_6);
+	frameStream << static_cast<quint32>(data.size()) << qChecksum(data.constData(), static_cast<uint>(data.size()));
+	frameStream.writeRawData(data.constData(), data.size());
+
+	return frame;
+}
+
+QByteArray HistoryJournal::createHeader()
+{
+	QByteArray header;
+	QDataStream stream(&header, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(JournalSignature) << static_cast<quint32>(JournalVersion);
+
+	return header;
+}
+
+QString HistoryJournal::getPath() const
+{
+	return m_path;
+}
+
+QString HistoryJournal::writeRecords(const QString &path, const QVector<Record> &records)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		return file.errorString();
+	}
+
+	QByteArray data(createHeader());
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		data.append(serializeRecord(records.at(i)));
+
+		if (data.size() > 65536)
+		{
+			if (file.write(data) != data.size())
+			{
+				return file.errorString();
+			}
+
+			data.clear();
+		}
+	}
+
+	if (file.write(data) != data.size() || !file.flush())
+	{
+		return file.errorString();
+	}
+
+	file.close();
+
+	return {};
+}
+
+int HistoryJournal::readRecords(const QString &path, const std::function<void(const Record &record)> &function, QString *errorString)
+{
+	const QString compactedPath(path + QLatin1String(".new"));
+
+	if (QFile::exists(compactedPath) && !SessionsManager::isReadOnly())
+	{
+		if (QFile::exists(path))
+		{
+			QFile::remove(compactedPath);
+		}
+		else
+		{
+			QFile::rename(compactedPath, path);
+		}
+	}
+
+	QFile file(path);
+
+	if (!file.exists())
+	{
+		return 0;
+	}
+
+	if (!file.open(SessionsManager::isReadOnly() ? QIODevice::ReadOnly : QIODevice::ReadWrite))
+	{
+		if (errorString)
+		{
+			*errorString = file.errorString();
+		}
+
+		return 0;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 signature(0);
+	quint32 version(0);
+
+	stream >> signature >> version;
+
+	if (signature != JournalSignature || version != JournalVersion)
+	{
+		if (errorString)
+		{
+			*errorString = tr("unsupported format");
+		}
+
+		file.close();
+
+		if (!SessionsManager::isReadOnly())
+		{
+			const QString backupPath(path + QLatin1String(".bak"));
+
+			QFile::remove(backupPath);
+			QFile::rename(path, backupPath);
+		}
+
+		return 0;
+	}
+
+	qint64 validSize(file.pos());
+	int amount(0);
+
+	while (!stream.atEnd())
+	{
+		quint32 size(0);
+		quint16 checksum(0);
+
+		stream >> size >> checksum;
+
+		if (stream.status() != QDataStream::Ok || size > static_cast<quint64>(file.size() - file.pos()))
+		{
+			break;
+		}
+
+		QByteArray data(static_cast<int>(size), Qt::Uninitialized);
+		Record record;
+
+		if (stream.readRawData(data.data(), data.size()) != data.size() || qChecksum(data.constData(), size) != checksum || !deserializeRecord(data, &record))
+		{
+			break;
+		}
+
+		function(record);
+
+		++amount;
+
+		validSize = file.pos();
+	}
+
+	if (validSize < file.size())
+	{
+		if (errorString)
+		{
+			*errorString = tr("discarded incomplete records after offset %1").arg(validSize);
+		}
+
+		if (!SessionsManager::isReadOnly())
+		{
+			file.resize(validSize);
+		}
+	}
+
+	file.close();
+
+	return amount;
+}
+
+int HistoryJournal::getRecordsAmount() const
+{
+	return (m_recordsAmount + m_pendingRecordsAmount);
+}
+
+bool HistoryJournal::deserializeRecord(const QByteArray &data, Record *record)
+{
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint8 type(UnknownRecord);
+
+	stream >> type >> record->identifier;
+
+	record->type = static_cast<RecordType>(type);
+
+	switch (record->type)
+	{
+		case AddRecord:
+		case UpdateRecord:
+			{
+				qint64 timeVisited(-1);
+
+				stream >> record->url >> record->title >> timeVisited;
+
+				if (timeVisited >= 0)
+				{
+					record->timeVisited = QDateTime::fromMSecsSinceEpoch(timeVisited, Qt::UTC);
+				}
+			}
+
+			break;
+		case RemoveRecord:
+		case ClearRecord:
+			break;
+		default:
+			return false;
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool HistoryJournal::appendData(const QByteArray &data)
+{
+	QFile file(m_path);
+	const qint64 size(file.exists() ? file.size() : 0);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		Console::addMessage(tr("Failed to write history journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		return false;
+	}
+
+	if ((size == 0 && file.write(createHeader()) < 0) || file.write(data) != data.size() || !file.flush())
+	{
+		Console::addMessage(tr("Failed to write history journal: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, m_path);
+
+		file.resize(size);
+
+		return false;
+	}
+
+	file.close();
+
+	return true;
+}
+
+bool HistoryJournal::isCompacting() const
+{
+	return m_isCompacting;
+}
+
+bool HistoryJournal::flush()
+{
+	if (m_pendingData.isEmpty())
+	{
+		return true;
+	}
+
+	if (SessionsManager::isReadOnly() || !appendData(m_pendingData))
+	{
+		return false;
+	}
+
+	if (m_isCompacting)
+	{
+		m_compactionData.append(m_pendingData);
+		m_compactionRecordsAmount += m_pendingRecordsAmount;
+	}
+
+	m_recordsAmount += m_pendingRecordsAmount;
+	m_pendingRecordsAmount = 0;
+
+	m_pendingData.clear();
+
+	return true;
+}
+
+}
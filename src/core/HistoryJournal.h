@@ -0,0 +1,98 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYJOURNAL_H
+#define OTTER_HISTORYJOURNAL_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+#include <functional>
+
+namespace Otter
+{
+
+class HistoryJournal final : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum RecordType : quint8
+	{
+		UnknownRecord = 0,
+		AddRecord,
+		UpdateRecord,
+		RemoveRecord,
+		ClearRecord
+	};
+
+	struct Record final
+	{
+		QString title;
+		QUrl url;
+		QDateTime timeVisited;
+		quint64 identifier = 0;
+		RecordType type = UnknownRecord;
+	};
+
+	explicit HistoryJournal(const QString &path, QObject *parent = nullptr);
+	~HistoryJournal();
+
+	void appendRecord(const Record &record);
+	void compact(const QVector<Record> &records);
+	void setRecordsAmount(int amount);
+	QString getPath() const;
+	static int readRecords(const QString &path, const std::function<void(const Record &record)> &function, QString *errorString = nullptr);
+	int getRecordsAmount() const;
+	bool isCompacting() const;
+	bool flush();
+
+protected:
+	enum JournalInformation : quint32
+	{
+		JournalSignature = 0x4F484A4C,
+		JournalVersion = 1
+	};
+
+	static QByteArray serializeRecord(const Record &record);
+	static QByteArray createHeader();
+	static QString writeRecords(const QString &path, const QVector<Record> &records);
+	static bool deserializeRecord(const QByteArray &data, Record *record);
+	bool appendData(const QByteArray &data);
+
+protected slots:
+	void handleCompactionFinished();
+
+private:
+	QFutureWatcher<QString> m_compactionWatcher;
+	QString m_path;
+	QByteArray m_pendingData;
+	QByteArray m_compactionData;
+	int m_recordsAmount;
+	int m_pendingRecordsAmount;
+	int m_compactedRecordsAmount;
+	int m_compactionRecordsAmount;
+	bool m_isCompacting;
+};
+
+}
+
+#endif
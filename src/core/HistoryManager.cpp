@@ -25,7 +25,9 @@
 #include "SettingsManager.h"
 #include "ThemesManager.h"
 
+#include <QtCore/QSet>
 #include <QtCore/QTimerEvent>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace Otter
 {
@@ -33,7 +35,11 @@ namespace Otter
 HistoryManager* HistoryManager::m_instance(nullptr);
 HistoryModel* HistoryManager::m_browsingHistoryModel(nullptr);
 HistoryModel* HistoryManager::m_typedHistoryModel(nullptr);
+FrecencyIndex HistoryManager::m_frecencyIndex;
+TextSearchIndex HistoryManager::m_textSearchIndex;
+VisitedLinksIndex HistoryManager::m_visitedLinksIndex;
 bool HistoryManager::m_isEnabled(false);
+bool HistoryManager::m_isTextSearchIndexed(false);
 bool HistoryManager::m_isStoringFavicons(true);
 
 HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
@@ -45,6 +51,7 @@ HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
 	handleOptionChanged(SettingsManager::History_StoreFaviconsOption);
 
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &HistoryManager::handleOptionChanged);
+	connect(&m_visitedLinksWatcher, &QFutureWatcher<VisitedLinksIndex::Fingerprints>::finished, this, &HistoryManager::handleVisitedLinksIndexed);
 }
 
 void HistoryManager::createInstance()
@@ -115,12 +122,12 @@ void HistoryManager::save()
 {
 	if (m_browsingHistoryModel)
 	{
-		m_browsingHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")));
+		m_browsingHistoryModel->flush();
 	}
 
 	if (m_typedHistoryModel)
 	{
-		m_typedHistoryModel->save(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")));
+		m_typedHistoryModel->flush();
 	}
 }
 
@@ -252,29 +259,205 @@ void HistoryManager::handleOptionChanged(int identifier)
 	}
 }
 
+void HistoryManager::handleHistoryLoaded()
+{
+	const HistoryModel *model(qobject_cast<HistoryModel*>(sender()));
+
+	if (!model)
+	{
+		return;
+	}
+
+	if (model == m_browsingHistoryModel)
+	{
+		QVector<QPair<quint64, QUrl> > entries;
+		entries.reserve(model->rowCount());
+
+		for (int i = 0; i < model->rowCount(); ++i)
+		{
+			const QModelIndex index(model->index(i, 0));
+
+			entries.append({index.data(HistoryModel::IdentifierRole).toULongLong(), index.data(HistoryModel::UrlRole).toUrl()});
+		}
+
+		m_textSearchIndex.clear();
+		m_visitedLinksIndex.beginRebuild();
+		m_visitedLinksWatcher.setFuture(QtConcurrent::run([=]()
+		{
+			return VisitedLinksIndex::createFingerprints(entries);
+		}));
+
+		m_isTextSearchIndexed = false;
+	}
+
+	addVisits(model);
+}
+
+void HistoryManager::handleHistoryCleared()
+{
+	if (sender() == m_browsingHistoryModel)
+	{
+		m_textSearchIndex.clear();
+		m_visitedLinksIndex.clear();
+	}
+
+	m_frecencyIndex.clear();
+
+	if (m_browsingHistoryModel)
+	{
+		addVisits(m_browsingHistoryModel);
+	}
+
+	if (m_typedHistoryModel)
+	{
+		addVisits(m_typedHistoryModel);
+	}
+}
+
+void HistoryManager::handleEntryAdded(HistoryModel::Entry *entry)
+{
+	if (m_isTextSearchIndexed)
+	{
+		indexEntry(entry);
+	}
+
+	m_visitedLinksIndex.addEntry(entry->getIdentifier(), entry->getUrl());
+}
+
+void HistoryManager::handleEntryModified(HistoryModel::Entry *entry)
+{
+	if (entry->getIdentifier() == 0)
+	{
+		return;
+	}
+
+	if (m_isTextSearchIndexed)
+	{
+		indexEntry(entry);
+	}
+
+	m_visitedLinksIndex.addEntry(entry->getIdentifier(), entry->getUrl());
+}
+
+void HistoryManager::handleEntriesRemoved(const QVector<HistoryModel::Entry*> &entries)
+{
+	const bool isBrowsingHistory(sender() == m_browsingHistoryModel);
+	QSet<QUrl> urls;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (isBrowsingHistory)
+		{
+			if (m_isTextSearchIndexed)
+			{
+				m_textSearchIndex.removeDocument(entries.at(i)->getIdentifier());
+			}
+
+			m_visitedLinksIndex.removeEntry(entries.at(i)->getIdentifier());
+		}
+
+		urls.insert(entries.at(i)->getUrl());
+	}
+
+	QSet<QUrl>::const_iterator iterator;
+
+	for (iterator = urls.constBegin(); iterator != urls.constEnd(); ++iterator)
+	{
+		updateRank(*iterator);
+	}
+}
+
+void HistoryManager::handleVisitedLinksIndexed()
+{
+	m_visitedLinksIndex.endRebuild(m_visitedLinksWatcher.result());
+}
+
+void HistoryManager::indexEntry(const HistoryModel::Entry *entry)
+{
+	m_textSearchIndex.addDocument(entry->getIdentifier(), entry->data(HistoryModel::TitleRole).toString() + QLatin1Char(' ') + entry->getUrl().toDisplayString());
+}
+
+void HistoryManager::addVisits(const HistoryModel *model, const QUrl &url)
+{
+	const FrecencyIndex::VisitType type((model->getType() == HistoryModel::TypedHistory) ? FrecencyIndex::TypedVisit : FrecencyIndex::LinkVisit);
+
+	if (url.isEmpty())
+	{
+		for (int i = 0; i < model->rowCount(); ++i)
+		{
+			const QModelIndex index(model->index(i, 0));
+
+			m_frecencyIndex.addVisit(Utils::normalizeUrl(index.data(HistoryModel::UrlRole).toUrl()), index.data(HistoryModel::TimeVisitedRole).toDateTime(), type);
+		}
+
+		return;
+	}
+
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const QVector<HistoryModel::Entry*> entries(model->getEntries(url));
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		m_frecencyIndex.addVisit(normalizedUrl, entries.at(i)->getTimeVisited(), type);
+	}
+}
+
+void HistoryManager::updateRank(const QUrl &url)
+{
+	m_frecencyIndex.removeUrl(Utils::normalizeUrl(url));
+
+	if (m_browsingHistoryModel)
+	{
+		addVisits(m_browsingHistoryModel, url);
+	}
+
+	if (m_typedHistoryModel)
+	{
+		addVisits(m_typedHistoryModel, url);
+	}
+}
+
 HistoryManager* HistoryManager::getInstance()
 {
 	return m_instance;
 }
 
+HistoryModel* HistoryManager::createModel(const QString &name, HistoryModel::HistoryType type)
+{
+	return new HistoryModel(SessionsManager::getWritableDataPath(name + QLatin1String(".dat")), SessionsManager::getWritableDataPath(name + QLatin1String(".json")), type, m_instance);
+}
+
 HistoryModel* HistoryManager::getBrowsingHistoryModel()
 {
 	if (!m_browsingHistoryModel)
 	{
-		m_browsingHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("browsingHistory.json")), HistoryModel::BrowsingHistory, m_instance);
+		m_browsingHistoryModel = createModel(QLatin1String("browsingHistory"), HistoryModel::BrowsingHistory);
 
+		connect(m_browsingHistoryModel, &HistoryModel::loaded, m_instance, &HistoryManager::handleHistoryLoaded);
+		connect(m_browsingHistoryModel, &HistoryModel::cleared, m_instance, &HistoryManager::handleHistoryCleared);
+		connect(m_browsingHistoryModel, &HistoryModel::entryAdded, m_instance, &HistoryManager::handleEntryAdded);
+		connect(m_browsingHistoryModel, &HistoryModel::entryModified, m_instance, &HistoryManager::handleEntryModified);
+		connect(m_browsingHistoryModel, &HistoryModel::entriesRemoved, m_instance, &HistoryManager::handleEntriesRemoved);
 		connect(m_browsingHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
 	}
 
 	return m_browsingHistoryModel;
 }
 
+const FrecencyIndex* HistoryManager::getFrecencyIndex()
+{
+	return &m_frecencyIndex;
+}
+
 HistoryModel* HistoryManager::getTypedHistoryModel()
 {
 	if (!m_typedHistoryModel && m_instance)
 	{
-		m_typedHistoryModel = new HistoryModel(SessionsManager::getWritableDataPath(QLatin1String("typedHistory.json")), HistoryModel::TypedHistory, m_instance);
+		m_typedHistoryModel = createModel(QLatin1String("typedHistory"), HistoryModel::TypedHistory);
 
+		connect(m_typedHistoryModel, &HistoryModel::loaded, m_instance, &HistoryManager::handleHistoryLoaded);
+		connect(m_typedHistoryModel, &HistoryModel::cleared, m_instance, &HistoryManager::handleHistoryCleared);
+		connect(m_typedHistoryModel, &HistoryModel::entriesRemoved, m_instance, &HistoryManager::handleEntriesRemoved);
 		connect(m_typedHistoryModel, &HistoryModel::modelModified, m_instance, &HistoryManager::scheduleSave);
 	}
 
@@ -328,14 +511,15 @@ HistoryModel::Entry* HistoryManager::getEntry(quint64 identifier)
 	return m_browsingHistoryModel->getEntry(identifier);
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly)
+QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QString &prefix, bool isTypedInOnly, int limit)
 {
 	if (!m_typedHistoryModel)
 	{
 		getTypedHistoryModel();
 	}
 
-	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true));
+	const FrecencyIndex *frecencyIndex(prefix.isEmpty() ? nullptr : &m_frecencyIndex);
+	QVector<HistoryModel::HistoryEntryMatch> entries(m_typedHistoryModel->findEntries(prefix, true, limit, frecencyIndex));
 
 	if (!isTypedInOnly)
 	{
@@ -344,12 +528,37 @@ QVector<HistoryModel::HistoryEntryMatch> HistoryManager::findEntries(const QStri
 			getBrowsingHistoryModel();
 		}
 
-		entries.append(m_browsingHistoryModel->findEntries(prefix));
+		entries.append(m_browsingHistoryModel->findEntries(prefix, false, limit, frecencyIndex));
 	}
 
 	return entries;
 }
 
+QVector<quint64> HistoryManager::searchEntries(const QString &query)
+{
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
+
+	if (!m_isTextSearchIndexed && !m_browsingHistoryModel->isLoading())
+	{
+		for (int i = 0; i < m_browsingHistoryModel->rowCount(); ++i)
+		{
+			const HistoryModel::Entry *entry(static_cast<HistoryModel::Entry*>(m_browsingHistoryModel->item(i, 0)));
+
+			if (entry)
+			{
+				indexEntry(entry);
+			}
+		}
+
+		m_isTextSearchIndexed = true;
+	}
+
+	return m_textSearchIndex.findDocuments(query);
+}
+
 quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool isTypedIn)
 {
 	if (!m_isEnabled || !url.isValid() || !SettingsManager::getOption(SettingsManager::History_RememberBrowsingOption, Utils::extractHost(url)).toBool())
@@ -362,7 +571,14 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 		getBrowsingHistoryModel();
 	}
 
-	const quint64 identifier(m_browsingHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc())->getIdentifier());
+	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	const quint64 identifier(m_browsingHistoryModel->addEntry(url, title, icon, currentDateTime)->getIdentifier());
+
+	if (!m_browsingHistoryModel->isLoading())
+	{
+		m_frecencyIndex.addVisit(normalizedUrl, currentDateTime, FrecencyIndex::LinkVisit);
+	}
 
 	if (isTypedIn)
 	{
@@ -371,17 +587,19 @@ quint64 HistoryManager::addEntry(const QUrl &url, const QString &title, const QI
 			getTypedHistoryModel();
 		}
 
-		m_typedHistoryModel->addEntry(url, title, icon, QDateTime::currentDateTimeUtc());
+		m_typedHistoryModel->addEntry(url, title, icon, currentDateTime);
+
+		if (!m_typedHistoryModel->isLoading())
+		{
+			m_frecencyIndex.addVisit(normalizedUrl, currentDateTime, FrecencyIndex::TypedVisit);
+		}
 	}
 
 	const int limit(SettingsManager::getOption(SettingsManager::History_BrowsingLimitAmountGlobalOption).toInt());
 
 	if (limit > 0 && m_browsingHistoryModel->rowCount() > limit)
 	{
-		for (int i = (m_browsingHistoryModel->rowCount() - 1); i >= limit; --i)
-		{
-			m_browsingHistoryModel->removeEntry(m_browsingHistoryModel->index(i, 0).data(HistoryModel::IdentifierRole).toULongLong());
-		}
+		m_browsingHistoryModel->clearExcessEntries(limit);
 	}
 
 	return identifier;
@@ -402,4 +620,24 @@ bool HistoryManager::hasEntry(const QUrl &url)
 	return m_browsingHistoryModel->hasEntry(url);
 }
 
+bool HistoryManager::isVisited(const QString &url)
+{
+	if (!m_isEnabled)
+	{
+		return false;
+	}
+
+	if (!m_browsingHistoryModel)
+	{
+		getBrowsingHistoryModel();
+	}
+
+	if (m_visitedLinksIndex.isReady())
+	{
+		return m_visitedLinksIndex.hasFingerprint(VisitedLinksIndex::createFingerprint(url));
+	}
+
+	return m_browsingHistoryModel->hasEntry(QUrl(url));
+}
+
 }
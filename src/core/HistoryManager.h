@@ -22,7 +22,10 @@
 #define OTTER_HISTORYMANAGER_H
 
 #include "HistoryModel.h"
+#include "TextSearchIndex.h"
+#include "VisitedLinksIndex.h"
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QUrl>
 #include <QtGui/QIcon>
 
@@ -42,12 +45,15 @@ public:
 	static HistoryManager* getInstance();
 	static HistoryModel* getBrowsingHistoryModel();
 	static HistoryModel* getTypedHistoryModel();
+	static const FrecencyIndex* getFrecencyIndex();
 	static QDateTime getLastVisitTime(const QUrl &url);
 	static QIcon getIcon(const QUrl &url);
 	static HistoryModel::Entry* getEntry(quint64 identifier);
-	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false);
+	static QVector<HistoryModel::HistoryEntryMatch> findEntries(const QString &prefix, bool isTypedInOnly = false, int limit = 0);
+	static QVector<quint64> searchEntries(const QString &query);
 	static quint64 addEntry(const QUrl &url, const QString &title = {}, const QIcon &icon = {}, bool isTypedIn = false);
 	static bool hasEntry(const QUrl &url);
+	static bool isVisited(const QString &url);
 
 protected:
 	explicit HistoryManager(QObject *parent);
@@ -55,18 +61,33 @@ protected:
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
 	void save();
+	static void indexEntry(const HistoryModel::Entry *entry);
+	static void addVisits(const HistoryModel *model, const QUrl &url = {});
+	static void updateRank(const QUrl &url);
+	static HistoryModel* createModel(const QString &name, HistoryModel::HistoryType type);
 
 protected slots:
 	void handleOptionChanged(int identifier);
+	void handleHistoryLoaded();
+	void handleHistoryCleared();
+	void handleEntryAdded(HistoryModel::Entry *entry);
+	void handleEntryModified(HistoryModel::Entry *entry);
+	void handleEntriesRemoved(const QVector<HistoryModel::Entry*> &entries);
+	void handleVisitedLinksIndexed();
 
 private:
+	QFutureWatcher<VisitedLinksIndex::Fingerprints> m_visitedLinksWatcher;
 	int m_dayTimer;
 	int m_saveTimer;
 
 	static HistoryManager *m_instance;
 	static HistoryModel *m_browsingHistoryModel;
 	static HistoryModel *m_typedHistoryModel;
+	static FrecencyIndex m_frecencyIndex;
+	static TextSearchIndex m_textSearchIndex;
+	static VisitedLinksIndex m_visitedLinksIndex;
 	static bool m_isEnabled;
+	static bool m_isTextSearchIndexed;
 	static bool m_isStoringFavicons;
 
 signals:
@@ -23,11 +23,18 @@
 #include "JsonSettings.h"
 #include "SessionsManager.h"
 #include "ThemesManager.h"
+#include "UrlInterner.h"
 #include "Utils.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
+#include <QtCore/QSet>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <limits>
 
 namespace Otter
 {
@@ -78,116 +85,163 @@ quint64 HistoryModel::Entry::getIdentifier() const
 	return data(IdentifierRole).toULongLong();
 }
 
-HistoryModel::HistoryModel(const QString &path, HistoryType type, QObject *parent) : QStandardItemModel(parent),
-	m_type(type)
+HistoryModel::HistoryModel(const QString &path, const QString &legacyPath, HistoryType type, QObject *parent) : QStandardItemModel(parent),
+	m_journal(new HistoryJournal(path, this)),
+	m_type(type),
+	m_isLoading(true)
 {
-	QFile file(path);
-
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-	{
-		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
-
-		return;
-	}
-
-	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+	setSortRole(TimeVisitedRole);
 
-	file.close();
+	connect(&m_loadingWatcher, &QFutureWatcher<LoadingResult>::finished, this, &HistoryModel::handleLoadingFinished);
 
-	for (int i = 0; i < historyArray.count(); ++i)
+	m_loadingWatcher.setFuture(QtConcurrent::run([=]()
 	{
-		const QJsonObject entryObject(historyArray.at(i).toObject());
-		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
-		dateTime.setTimeSpec(Qt::UTC);
-
-		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
-	}
+		return loadEntries(path, legacyPath);
+	}));
+}
 
-	setSortRole(TimeVisitedRole);
-	sort(0, Qt::DescendingOrder);
+HistoryModel::~HistoryModel()
+{
+	ensureLoaded();
 }
 
 void HistoryModel::clearExcessEntries(int limit)
 {
+	ensureLoaded();
+
 	if (limit > 0 && rowCount() > limit)
 	{
-		for (int i = (rowCount() - 1); i >= limit; --i)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		removeEntriesRange(limit, (rowCount() - limit));
 	}
 }
 
 void HistoryModel::clearRecentEntries(uint period)
 {
+	ensureLoaded();
+
 	if (period == 0)
 	{
 		clear();
 
+		QHash<quint32, QVector<Entry*> >::const_iterator iterator;
+
+		for (iterator = m_urls.constBegin(); iterator != m_urls.constEnd(); ++iterator)
+		{
+			UrlInterner::releaseUrl(iterator.key());
+		}
+
 		m_urls.clear();
+		m_urlsIndex.clear();
 		m_identifiers.clear();
 
+		journalEntry(HistoryJournal::ClearRecord, nullptr);
+
 		emit cleared();
 
 		return;
 	}
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
-	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().secsTo(QDateTime::currentDateTimeUtc()) < (period * 3600))
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
-	}
+	removeEntries(QDateTime::currentDateTimeUtc().addSecs(-static_cast<qint64>(period) * 3600), {});
 }
 
 void HistoryModel::clearOldestEntries(int period)
 {
+	ensureLoaded();
+
 	if (period < 0)
 	{
 		return;
 	}
 
-	const QDateTime currentDateTime(QDateTime::currentDateTimeUtc());
+	removeEntries({}, QDateTime(QDateTime::currentDateTimeUtc().date().addDays(-period), QTime(0, 0), Qt::UTC));
+}
 
-	for (int i = (rowCount() - 1); i >= 0; --i)
+void HistoryModel::removeEntry(quint64 identifier)
+{
+	const Entry *entry(getEntry(identifier));
+
+	if (entry)
 	{
-		if (index(i, 0).data(TimeVisitedRole).toDateTime().daysTo(currentDateTime) > period)
-		{
-			removeEntry(index(i, 0).data(IdentifierRole).toULongLong());
-		}
+		removeEntriesRange(entry->row(), 1);
 	}
 }
 
-void HistoryModel::removeEntry(quint64 identifier)
+void HistoryModel::removeEntries(const QDateTime &startTime, const QDateTime &endTime)
 {
-	Entry *entry(getEntry(identifier));
+	ensureLoaded();
 
-	if (!entry)
+	const int firstRow(endTime.isValid() ? findRow(endTime.toMSecsSinceEpoch()) : 0);
+	const int lastRow(findRow(startTime.isValid() ? startTime.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::min() + 1)));
+
+	removeEntriesRange(firstRow, (lastRow - firstRow));
+}
+
+void HistoryModel::removeEntriesRange(int row, int amount)
+{
+	amount = qMin(amount, (rowCount() - row));
+
+	if (row < 0 || amount <= 0)
 	{
 		return;
 	}
 
-	const QUrl url(Utils::normalizeUrl(entry->getUrl()));
+	const bool needsCompaction(amount > qMax(1000, (rowCount() - amount)));
+	QVector<Entry*> entries;
+	entries.reserve(amount);
+
+	QVector<QUrl> removedUrls;
 
-	if (m_urls.contains(url))
+	for (int i = row; i < (row + amount); ++i)
 	{
-		m_urls[url].removeAll(entry);
+		Entry *entry(static_cast<Entry*>(item(i, 0)));
 
-		if (m_urls[url].isEmpty())
+		if (!entry)
 		{
-			m_urls.remove(url);
+			continue;
 		}
-	}
 
-	if (identifier > 0 && m_identifiers.contains(identifier))
-	{
-		m_identifiers.remove(identifier);
+		const quint32 urlIdentifier(UrlInterner::findUrl(entry->getUrl()));
+		const QHash<quint32, QVector<Entry*> >::iterator iterator(m_urls.find(urlIdentifier));
+
+		if (iterator != m_urls.end())
+		{
+			iterator.value().removeAll(entry);
+
+			if (iterator.value().isEmpty())
+			{
+				m_urls.erase(iterator);
+
+				removedUrls.append(UrlInterner::getUrl(urlIdentifier));
+
+				UrlInterner::releaseUrl(urlIdentifier);
+			}
+		}
+
+		const quint64 identifier(entry->getIdentifier());
+
+		if (identifier > 0)
+		{
+			m_identifiers.remove(identifier);
+		}
+
+		if (!needsCompaction)
+		{
+			journalEntry(HistoryJournal::RemoveRecord, entry);
+		}
+
+		entries.append(entry);
 	}
 
-	emit entryRemoved(entry);
+	m_urlsIndex.removeUrls(removedUrls);
+
+	emit entriesRemoved(entries);
 
-	removeRow(entry->row());
+	removeRows(row, amount);
+
+	if (needsCompaction)
+	{
+		compactJournal();
+	}
 
 	emit modelModified();
 }
@@ -198,21 +252,18 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 
 	if (m_type == TypedHistory)
 	{
-		if (hasEntry(url))
-		{
-			const QUrl normalizedUrl(Utils::normalizeUrl(url));
+		const QVector<Entry*> entries(m_urls.value(UrlInterner::findUrl(url)));
 
-			for (int i = 0; i < m_urls[normalizedUrl].count(); ++i)
-			{
-				removeEntry(m_urls[normalizedUrl].at(i)->getIdentifier());
-			}
+		for (int i = 0; i < entries.count(); ++i)
+		{
+			removeEntry(entries.at(i)->getIdentifier());
 		}
 	}
 
 	Entry *entry(new Entry());
 	entry->setIcon(icon);
 
-	insertRow(0, entry);
+	insertRow(findRow(date.isValid() ? (date.toMSecsSinceEpoch() + 1) : (std::numeric_limits<qint64>::min() + 1)), entry);
 	setData(entry->index(), url, UrlRole);
 	setData(entry->index(), title, TitleRole);
 	setData(entry->index(), date, TimeVisitedRole);
@@ -226,6 +277,8 @@ HistoryModel::Entry* HistoryModel::addEntry(const QUrl &url, const QString &titl
 
 	m_identifiers[identifier] = entry;
 
+	journalEntry(HistoryJournal::AddRecord, entry);
+
 	blockSignals(false);
 
 	emit entryAdded(entry);
@@ -244,16 +297,53 @@ HistoryModel::Entry* HistoryModel::getEntry(quint64 identifier) const
 	return nullptr;
 }
 
-QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
+int HistoryModel::findRow(qint64 time) const
 {
-	const QUrl normalizedUrl(Utils::normalizeUrl(url));
+	int low(0);
+	int high(rowCount());
 
-	if (!m_urls.contains(normalizedUrl))
+	while (low < high)
 	{
-		return {};
+		const int middle(low + ((high - low) / 2));
+		const QDateTime timeVisited(index(middle, 0).data(TimeVisitedRole).toDateTime());
+
+		if ((timeVisited.isValid() ? timeVisited.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min()) >= time)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
 	}
 
-	const QVector<Entry*> entries(m_urls.value(normalizedUrl));
+	return low;
+}
+
+HistoryModel::Entry* HistoryModel::getLastEntry(const QUrl &url) const
+{
+	const QVector<Entry*> entries(m_urls.value(UrlInterner::findUrl(url)));
+	Entry *lastEntry(nullptr);
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (!lastEntry || entries.at(i)->getTimeVisited() > lastEntry->getTimeVisited())
+		{
+			lastEntry = entries.at(i);
+		}
+	}
+
+	return lastEntry;
+}
+
+QVector<HistoryModel::Entry*> HistoryModel::getEntries(const QUrl &url) const
+{
+	return m_urls.value(UrlInterner::findUrl(url));
+}
+
+QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
+{
+	const QVector<Entry*> entries(m_urls.value(UrlInterner::findUrl(url)));
 	QDateTime lastVisitTime;
 
 	for (int i = 0; i < entries.count(); ++i)
@@ -269,52 +359,401 @@ QDateTime HistoryModel::getLastVisitTime(const QUrl &url) const
 	return lastVisitTime;
 }
 
-QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn) const
+QVector<HistoryModel::HistoryEntryMatch> HistoryModel::findEntries(const QString &prefix, bool markAsTypedIn, int limit, const FrecencyIndex *frecencyIndex) const
 {
-	QVector<Entry*> matchedEntries;
-	QVector<HistoryEntryMatch> allMatches;
-	QVector<HistoryEntryMatch> currentMatches;
-	QMultiMap<QDateTime, HistoryEntryMatch> matchesMap;
-	QHash<QUrl, QVector<Entry*> >::const_iterator urlsIterator;
+	const qint64 matchesAmount(m_urlsIndex.getMatchesAmount(prefix));
+
+	if (matchesAmount == 0)
+	{
+		return {};
+	}
 
-	for (urlsIterator = m_urls.constBegin(); urlsIterator != m_urls.constEnd(); ++urlsIterator)
+	QVector<QPair<QUrl, Entry*> > matchedEntries;
+
+	if (frecencyIndex)
 	{
-		if (urlsIterator.value().isEmpty() || matchedEntries.contains(urlsIterator.value().value(0)))
+		QVector<QUrl> urls;
+
+		if (isScanCheaper(limit, frecencyIndex->getUrlsAmount(), matchesAmount))
 		{
-			continue;
+			urls = frecencyIndex->findUrls([&](const QUrl &url)
+			{
+				return (m_urls.contains(UrlInterner::findUrl(url)) && !Utils::matchUrl(url, prefix).isEmpty());
+			}, limit);
+		}
+		else
+		{
+			urls = frecencyIndex->selectUrls(m_urlsIndex.findUrls(prefix), limit);
+		}
+
+		matchedEntries.reserve(urls.count());
+
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			Entry *entry(getLastEntry(urls.at(i)));
+
+			if (entry)
+			{
+				matchedEntries.append({urls.at(i), entry});
+			}
+		}
+	}
+	else if (isScanCheaper(limit, rowCount(), matchesAmount))
+	{
+		QSet<QUrl> matchedUrls;
+
+		for (int i = 0; (i < rowCount() && matchedEntries.count() < limit); ++i)
+		{
+			Entry *entry(static_cast<Entry*>(item(i, 0)));
+
+			if (!entry)
+			{
+				continue;
+			}
+
+			const QUrl url(Utils::normalizeUrl(entry->getUrl()));
+
+			if (!matchedUrls.contains(url) && !Utils::matchUrl(url, prefix).isEmpty())
+			{
+				matchedUrls.insert(url);
+				matchedEntries.append({url, entry});
+			}
+		}
+	}
+	else
+	{
+		const QVector<QUrl> urls(m_urlsIndex.findUrls(prefix));
+
+		matchedEntries.reserve(urls.count());
+
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			Entry *lastEntry(getLastEntry(urls.at(i)));
+
+			if (lastEntry)
+			{
+				matchedEntries.append({urls.at(i), lastEntry});
+			}
+		}
+
+		const auto compareEntries([&](const QPair<QUrl, Entry*> &first, const QPair<QUrl, Entry*> &second)
+		{
+			return (first.second->getTimeVisited() > second.second->getTimeVisited());
+		});
+
+		if (limit > 0 && matchedEntries.count() > limit)
+		{
+			std::partial_sort(matchedEntries.begin(), (matchedEntries.begin() + limit), matchedEntries.end(), compareEntries);
+
+			matchedEntries.resize(limit);
+		}
+		else
+		{
+			std::sort(matchedEntries.begin(), matchedEntries.end(), compareEntries);
+		}
+	}
+
+	QVector<HistoryEntryMatch> matches;
+	matches.reserve(matchedEntries.count());
+
+	for (int i = 0; i < matchedEntries.count(); ++i)
+	{
+		HistoryEntryMatch match;
+		match.entry = matchedEntries.at(i).second;
+		match.match = Utils::matchUrl(matchedEntries.at(i).first, prefix);
+		match.isTypedIn = markAsTypedIn;
+
+		matches.append(match);
+	}
+
+	return matches;
+}
+
+void HistoryModel::compactJournal()
+{
+	QVector<HistoryJournal::Record> records;
+	records.reserve(m_identifiers.count());
+
+	QMap<quint64, Entry*>::const_iterator iterator;
+
+	for (iterator = m_identifiers.constBegin(); iterator != m_identifiers.constEnd(); ++iterator)
+	{
+		HistoryJournal::Record record;
+		record.title = iterator.value()->data(TitleRole).toString();
+		record.url = iterator.value()->getUrl();
+		record.timeVisited = iterator.value()->getTimeVisited();
+		record.identifier = iterator.key();
+		record.type = HistoryJournal::AddRecord;
+
+		records.append(record);
+	}
+
+	m_journal->compact(records);
+}
+
+void HistoryModel::journalEntry(HistoryJournal::RecordType type, const Entry *entry)
+{
+	HistoryJournal::Record record;
+	record.type = type;
+
+	if (entry)
+	{
+		record.identifier = entry->getIdentifier();
+
+		if (type == HistoryJournal::AddRecord || type == HistoryJournal::UpdateRecord)
+		{
+			record.title = entry->data(TitleRole).toString();
+			record.url = entry->getUrl();
+			record.timeVisited = entry->getTimeVisited();
+		}
+	}
+
+	m_journal->appendRecord(record);
+}
+
+void HistoryModel::ensureLoaded()
+{
+	if (m_isLoading)
+	{
+		m_loadingWatcher.waitForFinished();
+
+		handleLoadingFinished();
+	}
+}
+
+void HistoryModel::handleLoadingFinished()
+{
+	if (!m_isLoading)
+	{
+		return;
+	}
+
+	m_isLoading = false;
+
+	const LoadingResult result(m_loadingWatcher.result());
+
+	if (!result.errorString.isEmpty())
+	{
+		Console::addMessage(tr("Failed to load history: %1").arg(result.errorString), Console::OtherCategory, Console::WarningLevel, m_journal->getPath());
+	}
+
+	m_journal->setRecordsAmount(result.recordsAmount);
+
+	bool needsCompaction(result.isImported || result.recordsAmount > qMax(1000, (result.identifiers.count() * 2)));
+	QList<QStandardItem*> entries;
+	entries.reserve(result.identifiers.count());
+
+	QVector<QUrl> addedUrls;
+	addedUrls.reserve(result.urls.count());
+
+	QVector<quint32> urlIdentifiers(result.urls.count(), 0);
+
+	m_urls.reserve(m_urls.count() + result.urls.count());
+
+	beginResetModel();
+	blockSignals(true);
+
+	for (int i = 0; i < result.identifiers.count(); ++i)
+	{
+		const int urlIndex(result.urlIndexes.at(i));
+		const QUrl url(result.urls.at(urlIndex));
+
+		if (urlIdentifiers.at(urlIndex) == 0)
+		{
+			urlIdentifiers[urlIndex] = UrlInterner::internUrl(url);
 		}
 
-		const QString result(Utils::matchUrl(urlsIterator.key(), prefix));
+		const quint32 urlIdentifier(urlIdentifiers.at(urlIndex));
+		quint64 identifier(result.identifiers.at(i));
 
-		if (!result.isEmpty())
+		if (m_type == TypedHistory && m_urls.contains(urlIdentifier))
 		{
-			HistoryEntryMatch match;
-			match.entry = urlsIterator.value().value(0);
-			match.match = result;
+			needsCompaction = true;
 
-			if (markAsTypedIn)
+			continue;
+		}
+
+		if (m_identifiers.contains(identifier))
+		{
+			identifier = (m_identifiers.lastKey() + 1);
+
+			needsCompaction = true;
+		}
+
+		Entry *entry(new Entry());
+		entry->setItemData(url, UrlRole);
+		entry->setItemData(result.titles.at(result.titleIndexes.at(i)), TitleRole);
+		entry->setItemData(((result.timesVisited.at(i) < 0) ? QDateTime() : QDateTime::fromMSecsSinceEpoch(result.timesVisited.at(i), Qt::UTC)), TimeVisitedRole);
+		entry->setItemData(identifier, IdentifierRole);
+
+		if (urlIdentifier > 0)
+		{
+			if (!m_urls.contains(urlIdentifier))
 			{
-				match.isTypedIn = true;
+				addedUrls.append(UrlInterner::getUrl(urlIdentifier));
+
+				UrlInterner::retainUrl(urlIdentifier);
 			}
 
-			matchesMap.insert(match.entry->data(TimeVisitedRole).toDateTime(), match);
+			m_urls[urlIdentifier].append(entry);
+		}
+
+		m_identifiers[identifier] = entry;
 
-			matchedEntries.append(match.entry);
+		entries.append(entry);
+	}
+
+	invisibleRootItem()->appendRows(entries);
+
+	m_urlsIndex.addUrls(addedUrls);
+
+	blockSignals(false);
+	endResetModel();
+
+	emit loaded();
+
+	if (needsCompaction)
+	{
+		compactJournal();
+	}
+	else
+	{
+		m_journal->flush();
+	}
+}
+
+HistoryModel::LoadingResult HistoryModel::loadEntries(const QString &path, const QString &legacyPath)
+{
+	struct Row final
+	{
+		quint64 identifier = 0;
+		qint64 timeVisited = -1;
+		int urlIndex = 0;
+		int titleIndex = 0;
+	};
+
+	LoadingResult result;
+	QHash<QUrl, int> urls;
+	QHash<QString, int> titles;
+	QHash<quint64, Row> rows;
+	const auto createRow([&](quint64 identifier, const QUrl &url, const QString &title, const QDateTime &timeVisited)
+	{
+		Row row;
+		row.identifier = identifier;
+		row.timeVisited = (timeVisited.isValid() ? timeVisited.toMSecsSinceEpoch() : -1);
+
+		QHash<QUrl, int>::const_iterator urlIterator(urls.constFind(url));
+
+		if (urlIterator == urls.constEnd())
+		{
+			urlIterator = urls.insert(url, result.urls.count());
+
+			result.urls.append(url);
+		}
+
+		QHash<QString, int>::const_iterator titleIterator(titles.constFind(title));
+
+		if (titleIterator == titles.constEnd())
+		{
+			titleIterator = titles.insert(title, result.titles.count());
+
+			result.titles.append(title);
+		}
+
+		row.urlIndex = urlIterator.value();
+		row.titleIndex = titleIterator.value();
+
+		return row;
+	});
+
+	result.recordsAmount = HistoryJournal::readRecords(path, [&](const HistoryJournal::Record &record)
+	{
+		switch (record.type)
+		{
+			case HistoryJournal::AddRecord:
+				rows[record.identifier] = createRow(record.identifier, record.url, record.title, record.timeVisited);
+
+				break;
+			case HistoryJournal::UpdateRecord:
+				if (rows.contains(record.identifier))
+				{
+					rows[record.identifier] = createRow(record.identifier, record.url, record.title, record.timeVisited);
+				}
+
+				break;
+			case HistoryJournal::RemoveRecord:
+				rows.remove(record.identifier);
+
+				break;
+			case HistoryJournal::ClearRecord:
+				rows.clear();
+
+				break;
+			default:
+				break;
+		}
+	}, &result.errorString);
+
+	if (result.recordsAmount == 0 && !QFile::exists(path) && !legacyPath.isEmpty() && QFile::exists(legacyPath))
+	{
+		QFile file(legacyPath);
+
+		if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+		{
+			const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+
+			file.close();
+
+			rows.reserve(historyArray.count());
+
+			for (int i = 0; i < historyArray.count(); ++i)
+			{
+				const QJsonObject entryObject(historyArray.at(i).toObject());
+				QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
+				dateTime.setTimeSpec(Qt::UTC);
+
+				rows[static_cast<quint64>(i + 1)] = createRow(static_cast<quint64>(i + 1), QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), dateTime);
+			}
+
+			result.isImported = true;
+		}
+		else
+		{
+			result.errorString = file.errorString();
 		}
 	}
 
-	currentMatches = matchesMap.values().toVector();
+	QVector<Row> sortedRows;
+	sortedRows.reserve(rows.count());
 
-	matchesMap.clear();
+	QHash<quint64, Row>::const_iterator iterator;
+
+	for (iterator = rows.constBegin(); iterator != rows.constEnd(); ++iterator)
+	{
+		sortedRows.append(iterator.value());
+	}
+
+	std::sort(sortedRows.begin(), sortedRows.end(), [&](const Row &first, const Row &second)
+	{
+		return ((first.timeVisited == second.timeVisited) ? (first.identifier > second.identifier) : (first.timeVisited > second.timeVisited));
+	});
 
-	allMatches.reserve(currentMatches.count());
+	result.identifiers.reserve(sortedRows.count());
+	result.timesVisited.reserve(sortedRows.count());
+	result.urlIndexes.reserve(sortedRows.count());
+	result.titleIndexes.reserve(sortedRows.count());
 
-	for (int i = (currentMatches.count() - 1); i >= 0; --i)
+	for (int i = 0; i < sortedRows.count(); ++i)
 	{
-		allMatches.append(currentMatches.at(i));
+		const Row &row(sortedRows.at(i));
+
+		result.identifiers.append(row.identifier);
+		result.timesVisited.append(row.timeVisited);
+		result.urlIndexes.append(row.urlIndex);
+		result.titleIndexes.append(row.titleIndex);
 	}
 
-	return allMatches;
+	return result;
 }
 
 HistoryModel::HistoryType HistoryModel::getType() const
@@ -322,22 +761,53 @@ HistoryModel::HistoryType HistoryModel::getType() const
 	return m_type;
 }
 
-bool HistoryModel::save(const QString &path) const
+bool HistoryModel::importEntries(const QString &path)
+{
+	ensureLoaded();
+
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		Console::addMessage(tr("Failed to open history file: %1").arg(file.errorString()), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
+	}
+
+	const QJsonArray historyArray(QJsonDocument::fromJson(file.readAll()).array());
+
+	file.close();
+
+	for (int i = 0; i < historyArray.count(); ++i)
+	{
+		const QJsonObject entryObject(historyArray.at(i).toObject());
+		QDateTime dateTime(QDateTime::fromString(entryObject.value(QLatin1String("time")).toString(), Qt::ISODate));
+		dateTime.setTimeSpec(Qt::UTC);
+
+		addEntry(QUrl(entryObject.value(QLatin1String("url")).toString()), entryObject.value(QLatin1String("title")).toString(), {}, dateTime);
+	}
+
+	return flush();
+}
+
+bool HistoryModel::save(const QString &path)
 {
 	if (SessionsManager::isReadOnly())
 	{
 		return false;
 	}
 
+	ensureLoaded();
+
 	QJsonArray historyArray;
 
-	for (int i = 0; i < rowCount(); ++i)
+	for (int i = (rowCount() - 1); i >= 0; --i)
 	{
 		const QModelIndex index(this->index(i, 0));
 
 		if (index.isValid())
 		{
-			historyArray.prepend(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
+			historyArray.append(QJsonObject({{QLatin1String("url"), index.data(UrlRole).toUrl().toString()}, {QLatin1String("title"), index.data(TitleRole).toString()}, {QLatin1String("time"), index.data(TimeVisitedRole).toDateTime().toString(Qt::ISODate)}}));
 		}
 	}
 
@@ -347,6 +817,26 @@ bool HistoryModel::save(const QString &path) const
 	return settings.save(path);
 }
 
+bool HistoryModel::flush()
+{
+	if (m_isLoading)
+	{
+		return true;
+	}
+
+	if (!m_journal->flush())
+	{
+		return false;
+	}
+
+	if (!m_journal->isCompacting() && m_journal->getRecordsAmount() > qMax(1000, (rowCount() * 2)))
+	{
+		compactJournal();
+	}
+
+	return true;
+}
+
 bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
 	Entry *entry(static_cast<Entry*>(itemFromIndex(index)));
@@ -358,27 +848,33 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 
 	if (role == UrlRole && value.toUrl() != index.data(UrlRole).toUrl())
 	{
-		const QUrl oldUrl(Utils::normalizeUrl(index.data(UrlRole).toUrl()));
-		const QUrl newUrl(Utils::normalizeUrl(value.toUrl()));
+		const quint32 oldUrlIdentifier(UrlInterner::findUrl(index.data(UrlRole).toUrl()));
+		const quint32 newUrlIdentifier(UrlInterner::internUrl(value.toUrl()));
 
-		if (!oldUrl.isEmpty() && m_urls.contains(oldUrl))
+		if (oldUrlIdentifier > 0 && oldUrlIdentifier != newUrlIdentifier && m_urls.contains(oldUrlIdentifier))
 		{
-			m_urls[oldUrl].removeAll(entry);
+			m_urls[oldUrlIdentifier].removeAll(entry);
 
-			if (m_urls[oldUrl].isEmpty())
+			if (m_urls[oldUrlIdentifier].isEmpty())
 			{
-				m_urls.remove(oldUrl);
+				m_urls.remove(oldUrlIdentifier);
+				m_urlsIndex.removeUrl(UrlInterner::getUrl(oldUrlIdentifier));
+
+				UrlInterner::releaseUrl(oldUrlIdentifier);
 			}
 		}
 
-		if (!newUrl.isEmpty())
+		if (newUrlIdentifier > 0 && !m_urls.value(newUrlIdentifier).contains(entry))
 		{
-			if (!m_urls.contains(newUrl))
+			if (!m_urls.contains(newUrlIdentifier))
 			{
-				m_urls[newUrl] = QVector<Entry*>();
+				m_urls[newUrlIdentifier] = QVector<Entry*>();
+				m_urlsIndex.addUrl(UrlInterner::getUrl(newUrlIdentifier));
+
+				UrlInterner::retainUrl(newUrlIdentifier);
 			}
 
-			m_urls[newUrl].append(entry);
+			m_urls[newUrlIdentifier].append(entry);
 		}
 	}
 
@@ -388,8 +884,17 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 	{
 		case TitleRole:
 		case UrlRole:
-		case IdentifierRole:
 		case TimeVisitedRole:
+			if (!signalsBlocked())
+			{
+				journalEntry(HistoryJournal::UpdateRecord, entry);
+			}
+
+			emit entryModified(entry);
+			emit modelModified();
+
+			break;
+		case IdentifierRole:
 			emit entryModified(entry);
 			emit modelModified();
 
@@ -401,9 +906,23 @@ bool HistoryModel::setData(const QModelIndex &index, const QVariant &value, int
 	return true;
 }
 
+bool HistoryModel::isScanCheaper(int limit, qint64 entriesAmount, qint64 matchesAmount)
+{
+	// Collecting matches from the index costs about one step per match, while a scan in ranked order tests about entriesAmount * limit / matchesAmount entries before it finds enough of them
+	// Each of those tests is a full URL match, roughly eight times as expensive as one step over indexed matches
+	const qint64 urlMatchCost(8);
+
+	return (limit > 0 && (static_cast<qint64>(limit) * entriesAmount * urlMatchCost) < (matchesAmount * matchesAmount));
+}
+
 bool HistoryModel::hasEntry(const QUrl &url) const
 {
-	return m_urls.contains(Utils::normalizeUrl(url));
+	return m_urls.contains(UrlInterner::findUrl(url));
+}
+
+bool HistoryModel::isLoading() const
+{
+	return m_isLoading;
 }
 
 }
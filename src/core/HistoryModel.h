@@ -21,7 +21,12 @@
 #ifndef OTTER_HISTORYMODEL_H
 #define OTTER_HISTORYMODEL_H
 
+#include "FrecencyIndex.h"
+#include "HistoryJournal.h"
+#include "UrlPrefixIndex.h"
+
 #include <QtCore/QDateTime>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QUrl>
 #include <QtGui/QStandardItemModel>
 
@@ -71,31 +76,68 @@ public:
 		bool isTypedIn = false;
 	};
 
-	explicit HistoryModel(const QString &path, HistoryType type, QObject *parent = nullptr);
+	explicit HistoryModel(const QString &path, const QString &legacyPath, HistoryType type, QObject *parent = nullptr);
+	~HistoryModel();
 
 	void clearExcessEntries(int limit);
 	void clearRecentEntries(uint period);
 	void clearOldestEntries(int period);
 	void removeEntry(quint64 identifier);
+	void removeEntries(const QDateTime &startTime, const QDateTime &endTime);
 	Entry* addEntry(const QUrl &url, const QString &title, const QIcon &icon, const QDateTime &date = QDateTime::currentDateTimeUtc(), quint64 identifier = 0);
 	Entry* getEntry(quint64 identifier) const;
+	QVector<Entry*> getEntries(const QUrl &url) const;
 	QDateTime getLastVisitTime(const QUrl &url) const;
-	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false) const;
+	QVector<HistoryEntryMatch> findEntries(const QString &prefix, bool markAsTypedIn = false, int limit = 0, const FrecencyIndex *frecencyIndex = nullptr) const;
 	HistoryType getType() const;
 	bool hasEntry(const QUrl &url) const;
-	bool save(const QString &path) const;
+	bool isLoading() const;
+	bool importEntries(const QString &path);
+	bool save(const QString &path);
+	bool flush();
 	bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
+protected:
+	struct LoadingResult final
+	{
+		QVector<QUrl> urls;
+		QVector<QString> titles;
+		QVector<quint64> identifiers;
+		QVector<qint64> timesVisited;
+		QVector<int> urlIndexes;
+		QVector<int> titleIndexes;
+		QString errorString;
+		int recordsAmount = 0;
+		bool isImported = false;
+	};
+
+	void compactJournal();
+	void journalEntry(HistoryJournal::RecordType type, const Entry *entry);
+	void ensureLoaded();
+	void removeEntriesRange(int row, int amount);
+	Entry* getLastEntry(const QUrl &url) const;
+	int findRow(qint64 time) const;
+	static LoadingResult loadEntries(const QString &path, const QString &legacyPath);
+	static bool isScanCheaper(int limit, qint64 entriesAmount, qint64 matchesAmount);
+
+protected slots:
+	void handleLoadingFinished();
+
 private:
-	QHash<QUrl, QVector<Entry*> > m_urls;
+	HistoryJournal *m_journal;
+	QFutureWatcher<LoadingResult> m_loadingWatcher;
+	UrlPrefixIndex m_urlsIndex;
+	QHash<quint32, QVector<Entry*> > m_urls;
 	QMap<quint64, Entry*> m_identifiers;
 	HistoryType m_type;
+	bool m_isLoading;
 
 signals:
 	void cleared();
+	void loaded();
 	void entryAdded(Entry *entry);
 	void entryModified(Entry *entry);
-	void entryRemoved(Entry *entry);
+	void entriesRemoved(const QVector<Entry*> &entries);
 	void modelModified();
 };
 
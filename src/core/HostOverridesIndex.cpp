@@ -0,0 +1,208 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HostOverridesIndex.h"
+
+#include <algorithm>
+
+namespace Otter
+{
+
+HostOverridesIndex::HostOverridesIndex() : m_root(new Node())
+{
+}
+
+HostOverridesIndex::~HostOverridesIndex()
+{
+	delete m_root;
+}
+
+void HostOverridesIndex::setValue(const QString &host, int identifier, const QVariant &value)
+{
+	findPath(createLabels(host), true).last()->values[identifier] = value;
+}
+
+void HostOverridesIndex::removeValue(const QString &host, int identifier)
+{
+	const QStringList labels(createLabels(host));
+	const QVector<Node*> path(findPath(labels, false));
+
+	if (!path.isEmpty() && path.last()->values.remove(identifier) > 0)
+	{
+		prunePath(path, labels);
+	}
+}
+
+void HostOverridesIndex::removeHost(const QString &host)
+{
+	const QStringList labels(createLabels(host));
+	const QVector<Node*> path(findPath(labels, false));
+
+	if (!path.isEmpty())
+	{
+		path.last()->values.clear();
+
+		prunePath(path, labels);
+	}
+}
+
+void HostOverridesIndex::clear()
+{
+	delete m_root;
+
+	m_root = new Node();
+}
+
+void HostOverridesIndex::prunePath(const QVector<Node*> &path, const QStringList &labels)
+{
+	for (int i = (path.count() - 1); i > 0; --i)
+	{
+		Node *node(path.at(i));
+
+		if (!node->values.isEmpty() || !node->children.isEmpty())
+		{
+			break;
+		}
+
+		path.at(i - 1)->children.remove(labels.at(i - 1));
+
+		delete node;
+	}
+}
+
+void HostOverridesIndex::resolveValues(const QString &host, QVector<QVariant> &values) const
+{
+	const QVector<const Node*> nodes(findNodes(host));
+
+	for (int i = 0; i < nodes.count(); ++i)
+	{
+		QHash<int, QVariant>::const_iterator iterator;
+
+		for (iterator = nodes.at(i)->values.constBegin(); iterator != nodes.at(i)->values.constEnd(); ++iterator)
+		{
+			if (iterator.key() >= 0 && iterator.key() < values.count())
+			{
+				values[iterator.key()] = iterator.value();
+			}
+		}
+	}
+}
+
+QStringList HostOverridesIndex::createLabels(const QString &host)
+{
+	QStringList labels(host.split(QLatin1Char('.')));
+
+	std::reverse(labels.begin(), labels.end());
+
+	return labels;
+}
+
+QVariant HostOverridesIndex::getValue(const QString &host, int identifier) const
+{
+	const QVector<const Node*> nodes(findNodes(host));
+
+	for (int i = (nodes.count() - 1); i >= 0; --i)
+	{
+		const QHash<int, QVariant>::const_iterator iterator(nodes.at(i)->values.constFind(identifier));
+
+		if (iterator != nodes.at(i)->values.constEnd())
+		{
+			return iterator.value();
+		}
+	}
+
+	return {};
+}
+
+QVector<HostOverridesIndex::Node*> HostOverridesIndex::findPath(const QStringList &labels, bool canCreate)
+{
+	QVector<Node*> path({m_root});
+	path.reserve(labels.count() + 1);
+
+	for (int i = 0; i < labels.count(); ++i)
+	{
+		Node *node(path.last()->children.value(labels.at(i)));
+
+		if (!node)
+		{
+			if (!canCreate)
+			{
+				return {};
+			}
+
+			node = new Node();
+
+			path.last()->children[labels.at(i)] = node;
+		}
+
+		path.append(node);
+	}
+
+	return path;
+}
+
+QVector<const HostOverridesIndex::Node*> HostOverridesIndex::findNodes(const QString &host) const
+{
+	QVector<const Node*> nodes;
+
+	if (host.isEmpty() || m_root->children.isEmpty())
+	{
+		return nodes;
+	}
+
+	const Node *node(m_root);
+	int end(host.length());
+
+	while (end > 0)
+	{
+		const int start(host.lastIndexOf(QLatin1Char('.'), (end - 1)));
+
+		node = node->children.value(host.mid((start + 1), (end - start - 1)));
+
+		if (!node)
+		{
+			break;
+		}
+
+		if (start < 0)
+		{
+			nodes.append(node);
+
+			break;
+		}
+
+		const Node *wildcardNode(node->children.value(QLatin1String("*")));
+
+		if (wildcardNode)
+		{
+			nodes.append(wildcardNode);
+		}
+
+		end = start;
+	}
+
+	return nodes;
+}
+
+bool HostOverridesIndex::isEmpty() const
+{
+	return m_root->children.isEmpty();
+}
+
+}
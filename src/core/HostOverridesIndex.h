@@ -0,0 +1,70 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HOSTOVERRIDESINDEX_H
+#define OTTER_HOSTOVERRIDESINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class HostOverridesIndex final
+{
+public:
+	HostOverridesIndex();
+	~HostOverridesIndex();
+
+	void setValue(const QString &host, int identifier, const QVariant &value);
+	void removeValue(const QString &host, int identifier);
+	void removeHost(const QString &host);
+	void clear();
+	void resolveValues(const QString &host, QVector<QVariant> &values) const;
+	QVariant getValue(const QString &host, int identifier) const;
+	bool isEmpty() const;
+
+protected:
+	struct Node final
+	{
+		QHash<QString, Node*> children;
+		QHash<int, QVariant> values;
+
+		~Node()
+		{
+			qDeleteAll(children);
+		}
+	};
+
+	void prunePath(const QVector<Node*> &path, const QStringList &labels);
+	QVector<Node*> findPath(const QStringList &labels, bool canCreate);
+	QVector<const Node*> findNodes(const QString &host) const;
+	static QStringList createLabels(const QString &host);
+
+private:
+	Node *m_root;
+
+	Q_DISABLE_COPY(HostOverridesIndex)
+};
+
+}
+
+#endif
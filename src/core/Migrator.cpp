@@ -240,6 +240,8 @@ public:
 		optionsMap[QLatin1String("Browser/TabCrashingActionOption")] = SettingsManager::Interface_TabCrashingActionOption;
 		optionsMap[QLatin1String("Content/PopupsPolicy")] = SettingsManager::Permissions_ScriptsCanOpenWindowsOption;
 
+		SettingsManager::saveOptions();
+
 		QMap<QString, SettingsManager::OptionIdentifier>::iterator optionsIterator;
 		QSettings configuration(SettingsManager::getGlobalPath(), QSettings::IniFormat);
 		const QStringList configurationKeys(configuration.allKeys());
@@ -312,6 +314,11 @@ public:
 
 			ToolBarsManager::setToolBar(sidebarDefiniton);
 		}
+
+		configuration.sync();
+		overrides.sync();
+
+		SettingsManager::loadOptions();
 	}
 
 	QString getName() const override
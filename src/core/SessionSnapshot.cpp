@@ -0,0 +1,458 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "SessionSnapshot.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+SessionSnapshot::SessionSnapshot(const QString &path) :
+	m_path(path),
+	m_size(0),
+	m_needsCompaction(true)
+{
+}
+
+void SessionSnapshot::setWindow(quint64 identifier, const Session::MainWindow &window, const QStringList &excludedOptions)
+{
+	const QByteArray data(serializeWindow(window, excludedOptions));
+	QHash<quint64, QByteArray>::iterator iterator(m_windows.find(identifier));
+
+	if (iterator != m_windows.end())
+	{
+		if (iterator.value() == data)
+		{
+			return;
+		}
+
+		iterator.value() = data;
+	}
+	else
+	{
+		m_windows[identifier] = data;
+	}
+
+	m_pendingData.append(serializeRecord(WindowRecord, identifier, data));
+}
+
+Session::MainWindow SessionSnapshot::deserializeWindow(const QByteArray &data, bool *isValid)
+{
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	Session::MainWindow window;
+	qint32 index(-1);
+	quint32 toolBarsAmount(0);
+
+	stream >> window.geometry >> index >> window.hasToolBarsState >> window.splitters >> toolBarsAmount;
+
+	window.index = index;
+	window.toolBars.reserve(static_cast<int>(qMin(toolBarsAmount, static_cast<quint32>(1024))));
+
+	for (quint32 i = 0; i < toolBarsAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QString identifier;
+		qint32 location(Qt::NoToolBarArea);
+		qint32 row(-1);
+		quint8 normalVisibility(Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar);
+		quint8 fullScreenVisibility(Session::MainWindow::ToolBarState::UnspecifiedVisibilityToolBar);
+
+		stream >> identifier >> location >> row >> normalVisibility >> fullScreenVisibility;
+
+		Session::MainWindow::ToolBarState toolBarState;
+		toolBarState.identifier = ToolBarsManager::getToolBarIdentifier(identifier);
+		toolBarState.location = static_cast<Qt::ToolBarArea>(location);
+		toolBarState.row = row;
+		toolBarState.normalVisibility = static_cast<Session::MainWindow::ToolBarState::ToolBarVisibility>(normalVisibility);
+		toolBarState.fullScreenVisibility = static_cast<Session::MainWindow::ToolBarState::ToolBarVisibility>(fullScreenVisibility);
+
+		window.toolBars.append(toolBarState);
+	}
+
+	quint32 windowsAmount(0);
+
+	stream >> windowsAmount;
+
+	for (quint32 i = 0; i < windowsAmount && stream.status() == QDataStream::Ok; ++i)
+	{
+		Session::Window sessionWindow;
+		QVariantMap options;
+		qint32 state(Qt::WindowNoState);
+		qint32 historyIndex(-1);
+		quint32 entriesAmount(0);
+
+		stream >> sessionWindow.identity >> sessionWindow.state.geometry >> state >> options >> historyIndex >> sessionWindow.isAlwaysOnTop >> sessionWindow.isPinned >> entriesAmount;
+
+		sessionWindow.state.state = static_cast<Qt::WindowState>(state);
+		sessionWindow.history.index = historyIndex;
+
+		QVariantMap::const_iterator iterator;
+
+		for (iterator = options.constBegin(); iterator != options.constEnd(); ++iterator)
+		{
+			const int identifier(SettingsManager::getOptionIdentifier(iterator.key()));
+
+			if (identifier >= 0)
+			{
+				sessionWindow.options[identifier] = iterator.value();
+			}
+		}
+
+		for (quint32 j = 0; j < entriesAmount && stream.status() == QDataStream::Ok; ++j)
+		{
+			Session::Window::History::Entry entry;
+			qint32 zoom(0);
+
+			stream >> entry.url >> entry.title >> entry.position >> zoom;
+
+			entry.zoom = zoom;
+
+			sessionWindow.history.entries.append(entry);
+		}
+
+		if (sessionWindow.history.index < 0 || sessionWindow.history.index >= sessionWindow.history.entries.count())
+		{
+			sessionWindow.history.index = (sessionWindow.history.entries.count() - 1);
+		}
+
+		window.windows.append(sessionWindow);
+	}
+
+	if (window.index < 0 || window.index >= window.windows.count())
+	{
+		window.index = (window.windows.count() - 1);
+	}
+
+	*isValid = (stream.status() == QDataStream::Ok);
+
+	return window;
+}
+
+QByteArray SessionSnapshot::serializeRecord(RecordType type, quint64 identifier, const QByteArray &data)
+{
+	QByteArray frame;
+	QDataStream stream(&frame, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(data.size()) << qChecksum(data.constData(), static_cast<uint>(data.size())) << static_cast<quint8>(type) << identifier;
+	stream.writeRawData(data.constData(), data.size());
+
+	return frame;
+}
+
+QByteArray SessionSnapshot::serializeWindow(const Session::MainWindow &window, const QStringList &excludedOptions)
+{
+	QVector<QPair<QString, Session::MainWindow::ToolBarState> > toolBars;
+	toolBars.reserve(window.toolBars.count());
+
+	for (int i = 0; i < window.toolBars.count(); ++i)
+	{
+		const QString identifier(ToolBarsManager::getToolBarName(window.toolBars.at(i).identifier));
+
+		if (!identifier.isEmpty())
+		{
+			toolBars.append({identifier, window.toolBars.at(i)});
+		}
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << window.geometry << static_cast<qint32>(window.index) << window.hasToolBarsState << window.splitters << static_cast<quint32>(toolBars.count());
+
+	for (int i = 0; i < toolBars.count(); ++i)
+	{
+		const Session::MainWindow::ToolBarState &toolBarState(toolBars.at(i).second);
+
+		stream << toolBars.at(i).first << static_cast<qint32>(toolBarState.location) << static_cast<qint32>(toolBarState.row) << static_cast<quint8>(toolBarState.normalVisibility) << static_cast<quint8>(toolBarState.fullScreenVisibility);
+	}
+
+	stream << static_cast<quint32>(window.windows.count());
+
+	for (int i = 0; i < window.windows.count(); ++i)
+	{
+		const Session::Window &sessionWindow(window.windows.at(i));
+		QVariantMap options;
+		QHash<int, QVariant>::const_iterator iterator;
+
+		for (iterator = sessionWindow.options.constBegin(); iterator != sessionWindow.options.constEnd(); ++iterator)
+		{
+			const QString name(SettingsManager::getOptionName(iterator.key()));
+
+			if (!name.isEmpty() && !excludedOptions.contains(name))
+			{
+				options[name] = iterator.value();
+			}
+		}
+
+		stream << sessionWindow.identity << sessionWindow.state.geometry << static_cast<qint32>(sessionWindow.state.state) << options << static_cast<qint32>(sessionWindow.history.index) << sessionWindow.isAlwaysOnTop << sessionWindow.isPinned << static_cast<quint32>(sessionWindow.history.entries.count());
+
+		for (int j = 0; j < sessionWindow.history.entries.count(); ++j)
+		{
+			const Session::Window::History::Entry &entry(sessionWindow.history.entries.at(j));
+
+			stream << entry.url << entry.title << entry.position << static_cast<qint32>(entry.zoom);
+		}
+	}
+
+	return data;
+}
+
+QByteArray SessionSnapshot::serializeSession(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean)
+{
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << title << isClean << identifiers << activeIdentifier;
+
+	return data;
+}
+
+QByteArray SessionSnapshot::createHeader()
+{
+	QByteArray header;
+	QDataStream stream(&header, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << static_cast<quint32>(SnapshotSignature) << static_cast<quint32>(SnapshotVersion);
+
+	return header;
+}
+
+QString SessionSnapshot::getPath() const
+{
+	return m_path;
+}
+
+SessionInformation SessionSnapshot::readSession(const QString &path, QString *errorString)
+{
+	SessionInformation session;
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		if (errorString)
+		{
+			*errorString = file.errorString();
+		}
+
+		return session;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 signature(0);
+	quint32 version(0);
+
+	stream >> signature >> version;
+
+	if (signature != SnapshotSignature || version == 0 || version > SnapshotVersion)
+	{
+		if (errorString)
+		{
+			*errorString = QCoreApplication::translate("main", "unsupported format");
+		}
+
+		return session;
+	}
+
+	QHash<quint64, QByteArray> windows;
+	QVector<quint64> identifiers;
+	quint64 activeIdentifier(0);
+	bool hasSession(false);
+
+	while (!stream.atEnd())
+	{
+		quint32 size(0);
+		quint16 checksum(0);
+		quint8 type(UnknownRecord);
+		quint64 identifier(0);
+
+		stream >> size >> checksum >> type >> identifier;
+
+		if (stream.status() != QDataStream::Ok || size > static_cast<quint64>(file.size() - file.pos()))
+		{
+			break;
+		}
+
+		QByteArray data(static_cast<int>(size), Qt::Uninitialized);
+
+		if (stream.readRawData(data.data(), data.size()) != data.size() || qChecksum(data.constData(), size) != checksum)
+		{
+			break;
+		}
+
+		switch (type)
+		{
+			case WindowRecord:
+				windows[identifier] = data;
+
+				break;
+			case RemoveWindowRecord:
+				windows.remove(identifier);
+
+				break;
+			case SessionRecord:
+				{
+					QDataStream sessionStream(data);
+					sessionStream.setVersion(QDataStream::Qt_5_6);
+					sessionStream >> session.title >> session.isClean >> identifiers;
+
+					if (version > 1)
+					{
+						sessionStream >> activeIdentifier;
+					}
+
+					hasSession = (sessionStream.status() == QDataStream::Ok);
+				}
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (!stream.atEnd() && errorString)
+	{
+		*errorString = QCoreApplication::translate("main", "discarded incomplete records after offset %1").arg(file.pos());
+	}
+
+	file.close();
+
+	if (!hasSession)
+	{
+		return {};
+	}
+
+	session.index = -1;
+	session.windows.reserve(identifiers.count());
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		if (!windows.contains(identifiers.at(i)))
+		{
+			continue;
+		}
+
+		bool isValid(false);
+		const Session::MainWindow window(deserializeWindow(windows[identifiers.at(i)], &isValid));
+
+		if (isValid)
+		{
+			if (identifiers.at(i) == activeIdentifier)
+			{
+				session.index = session.windows.count();
+			}
+
+			session.windows.append(window);
+		}
+	}
+
+	if (session.index < 0 && !session.windows.isEmpty())
+	{
+		session.index = 0;
+	}
+
+	return session;
+}
+
+bool SessionSnapshot::hasWindow(quint64 identifier) const
+{
+	return m_windows.contains(identifier);
+}
+
+bool SessionSnapshot::save(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean)
+{
+	QHash<quint64, QByteArray>::iterator iterator(m_windows.begin());
+	qint64 size(createHeader().size());
+
+	while (iterator != m_windows.end())
+	{
+		if (identifiers.contains(iterator.key()))
+		{
+			size += iterator.value().size();
+
+			++iterator;
+		}
+		else
+		{
+			m_pendingData.append(serializeRecord(RemoveWindowRecord, iterator.key(), {}));
+
+			iterator = m_windows.erase(iterator);
+		}
+	}
+
+	if (m_needsCompaction || (m_size + m_pendingData.size()) > ((size * 2) + 65536))
+	{
+		return compact(title, identifiers, activeIdentifier, isClean);
+	}
+
+	m_pendingData.append(serializeRecord(SessionRecord, 0, serializeSession(title, identifiers, activeIdentifier, isClean)));
+
+	QFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(m_pendingData) != m_pendingData.size() || !file.flush())
+	{
+		return compact(title, identifiers, activeIdentifier, isClean);
+	}
+
+	file.close();
+
+	m_size += m_pendingData.size();
+
+	m_pendingData.clear();
+
+	return true;
+}
+
+bool SessionSnapshot::compact(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean)
+{
+	QByteArray data(createHeader());
+
+	for (int i = 0; i < identifiers.count(); ++i)
+	{
+		if (m_windows.contains(identifiers.at(i)))
+		{
+			data.append(serializeRecord(WindowRecord, identifiers.at(i), m_windows[identifiers.at(i)]));
+		}
+	}
+
+	data.append(serializeRecord(SessionRecord, 0, serializeSession(title, identifiers, activeIdentifier, isClean)));
+
+	m_pendingData.clear();
+
+	QSaveFile file(m_path);
+
+	if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+	{
+		m_needsCompaction = true;
+
+		return false;
+	}
+
+	m_size = data.size();
+	m_needsCompaction = false;
+
+	return true;
+}
+
+}
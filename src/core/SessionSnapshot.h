@@ -0,0 +1,71 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SESSIONSNAPSHOT_H
+#define OTTER_SESSIONSNAPSHOT_H
+
+#include "SessionsManager.h"
+
+namespace Otter
+{
+
+class SessionSnapshot final
+{
+public:
+	explicit SessionSnapshot(const QString &path);
+
+	void setWindow(quint64 identifier, const Session::MainWindow &window, const QStringList &excludedOptions);
+	QString getPath() const;
+	static SessionInformation readSession(const QString &path, QString *errorString = nullptr);
+	bool hasWindow(quint64 identifier) const;
+	bool save(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean);
+
+protected:
+	enum RecordType : quint8
+	{
+		UnknownRecord = 0,
+		WindowRecord,
+		RemoveWindowRecord,
+		SessionRecord
+	};
+
+	enum SnapshotInformation : quint32
+	{
+		SnapshotSignature = 0x4F53534E,
+		SnapshotVersion = 2
+	};
+
+	static Session::MainWindow deserializeWindow(const QByteArray &data, bool *isValid);
+	static QByteArray serializeRecord(RecordType type, quint64 identifier, const QByteArray &data);
+	static QByteArray serializeWindow(const Session::MainWindow &window, const QStringList &excludedOptions);
+	static QByteArray serializeSession(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean);
+	static QByteArray createHeader();
+	bool compact(const QString &title, const QVector<quint64> &identifiers, quint64 activeIdentifier, bool isClean);
+
+private:
+	QString m_path;
+	QByteArray m_pendingData;
+	QHash<quint64, QByteArray> m_windows;
+	qint64 m_size;
+	bool m_needsCompaction;
+};
+
+}
+
+#endif
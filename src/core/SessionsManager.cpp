@@ -20,8 +20,10 @@
 
 #include "SessionsManager.h"
 #include "Application.h"
+#include "Console.h"
 #include "JsonSettings.h"
 #include "SessionModel.h"
+#include "SessionSnapshot.h"
 #include "../ui/MainWindow.h"
 #include "../ui/Window.h"
 
@@ -38,12 +40,15 @@ Session::Session(QObject *parent) : QObject(parent)
 
 SessionsManager* SessionsManager::m_instance(nullptr);
 SessionModel* SessionsManager::m_model(nullptr);
+SessionSnapshot* SessionsManager::m_snapshot(nullptr);
 QString SessionsManager::m_sessionPath;
 QString SessionsManager::m_sessionTitle;
 QString SessionsManager::m_cachePath;
 QString SessionsManager::m_profilePath;
 QHash<QString, Session::Identity> SessionsManager::m_identities;
 QVector<Session::MainWindow> SessionsManager::m_closedWindows;
+QSet<quint64> SessionsManager::m_modifiedWindows;
+bool SessionsManager::m_areAllWindowsModified(true);
 bool SessionsManager::m_isDirty(false);
 bool SessionsManager::m_isPrivate(false);
 bool SessionsManager::m_isReadOnly(false);
@@ -65,7 +70,7 @@ void SessionsManager::timerEvent(QTimerEvent *event)
 
 		if (!m_isPrivate)
 		{
-			saveSession({}, {}, nullptr, false);
+			saveSnapshot();
 		}
 	}
 }
@@ -90,6 +95,61 @@ void SessionsManager::scheduleSave()
 	}
 }
 
+void SessionsManager::saveSnapshot()
+{
+	const QString path(getSnapshotPath(m_sessionPath));
+
+	if (m_snapshot && m_snapshot->getPath() != path)
+	{
+		delete m_snapshot;
+
+		m_snapshot = nullptr;
+	}
+
+	if (!m_snapshot)
+	{
+		QDir().mkpath(m_profilePath + QLatin1String("/sessions/"));
+
+		m_snapshot = new SessionSnapshot(path);
+		m_areAllWindowsModified = true;
+	}
+
+	const QStringList excludedOptions(SettingsManager::getOption(SettingsManager::Sessions_OptionsExludedFromSavingOption).toStringList());
+	const QVector<MainWindow*> windows(Application::getWindows());
+	const MainWindow *activeWindow(Application::getActiveWindow());
+	QVector<quint64> identifiers;
+	identifiers.reserve(windows.count());
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		const MainWindow *mainWindow(windows.at(i));
+
+		if (mainWindow->isPrivate())
+		{
+			continue;
+		}
+
+		const quint64 identifier(mainWindow->getIdentifier());
+
+		if (m_areAllWindowsModified || m_modifiedWindows.contains(identifier) || !m_snapshot->hasWindow(identifier))
+		{
+			m_snapshot->setWindow(identifier, mainWindow->getSession(), excludedOptions);
+		}
+
+		identifiers.append(identifier);
+	}
+
+	m_modifiedWindows.clear();
+	m_areAllWindowsModified = false;
+
+	if (!m_snapshot->save(m_sessionTitle, identifiers, ((activeWindow && !activeWindow->isPrivate()) ? activeWindow->getIdentifier() : 0), false))
+	{
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save session snapshot"), Console::OtherCategory, Console::ErrorLevel, path);
+
+		m_areAllWindowsModified = true;
+	}
+}
+
 void SessionsManager::clearClosedWindows()
 {
 	m_closedWindows.clear();
@@ -124,9 +184,28 @@ void SessionsManager::storeClosedWindow(MainWindow *mainWindow)
 	emit m_instance->closedWindowsChanged();
 }
 
-void SessionsManager::markSessionAsModified()
+void SessionsManager::markSessionAsModified(QObject *source)
 {
-	if (!m_isPrivate && !m_isDirty && m_sessionPath == QLatin1String("default"))
+	if (m_isPrivate)
+	{
+		return;
+	}
+
+	while (source && !qobject_cast<MainWindow*>(source))
+	{
+		source = source->parent();
+	}
+
+	if (source)
+	{
+		m_modifiedWindows.insert(qobject_cast<MainWindow*>(source)->getIdentifier());
+	}
+	else
+	{
+		m_areAllWindowsModified = true;
+	}
+
+	if (!m_isDirty && m_sessionPath == QLatin1String("default"))
 	{
 		m_isDirty = true;
 
@@ -181,6 +260,14 @@ QString SessionsManager::getWritableDataPath(const QString &path)
 	return QDir::toNativeSeparators(m_profilePath + QDir::separator() + path);
 }
 
+QString SessionsManager::getSnapshotPath(const QString &path)
+{
+	QString snapshotPath(getSessionPath(path));
+	snapshotPath.chop(5);
+
+	return snapshotPath + QLatin1String(".snapshot");
+}
+
 QString SessionsManager::getSessionPath(const QString &path, bool isBound)
 {
 	QString normalizedPath(path);
@@ -216,6 +303,32 @@ Session::Identity SessionsManager::getIdentity(const QString &name)
 
 SessionInformation SessionsManager::getSession(const QString &path)
 {
+	const QFileInfo sessionInformation(getSessionPath(path));
+	const QFileInfo snapshotInformation(getSnapshotPath(path));
+
+	if (snapshotInformation.exists() && (!sessionInformation.exists() || snapshotInformation.lastModified() >= sessionInformation.lastModified()))
+	{
+		QString errorString;
+		SessionInformation session(SessionSnapshot::readSession(snapshotInformation.absoluteFilePath(), &errorString));
+
+		if (!errorString.isEmpty())
+		{
+			Console::addMessage(QCoreApplication::translate("main", "Failed to load session snapshot: %1").arg(errorString), Console::OtherCategory, Console::WarningLevel, snapshotInformation.absoluteFilePath());
+		}
+
+		if (session.isValid())
+		{
+			session.path = path;
+
+			if (session.title.isEmpty())
+			{
+				session.title = ((path == QLatin1String("default")) ? tr("Default") : tr("(Untitled)"));
+			}
+
+			return session;
+		}
+	}
+
 	SessionInformation session;
 	const JsonSettings settings(getSessionPath(path));
 
@@ -847,12 +960,33 @@ bool SessionsManager::saveSession(const SessionInformation &session)
 	JsonSettings settings;
 	settings.setObject(sessionObject);
 
-	return settings.save(path);
+	if (!settings.save(path))
+	{
+		return false;
+	}
+
+	if (session.isClean && QFileInfo(path) == QFileInfo(getSessionPath(m_sessionPath)))
+	{
+		QFile::remove(getSnapshotPath(m_sessionPath));
+
+		if (m_snapshot)
+		{
+			delete m_snapshot;
+
+			m_snapshot = nullptr;
+		}
+	}
+
+	return true;
 }
 
 bool SessionsManager::deleteSession(const QString &path)
 {
 	const QString normalizedPath(getSessionPath(path, true));
+	QString snapshotPath(normalizedPath);
+	snapshotPath.chop(5);
+
+	QFile::remove(snapshotPath + QLatin1String(".snapshot"));
 
 	if (QFile::exists(normalizedPath))
 	{
@@ -28,12 +28,14 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QRect>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
 class MainWindow;
 class SessionModel;
+class SessionSnapshot;
 
 class Session final : public QObject
 {
@@ -242,7 +244,7 @@ public:
 	static void createInstance(const QString &profilePath, const QString &cachePath, bool isPrivate = false, bool isReadOnly = false);
 	static void clearClosedWindows();
 	static void storeClosedWindow(MainWindow *mainWindow);
-	static void markSessionAsModified();
+	static void markSessionAsModified(QObject *source = nullptr);
 	static void removeStoredUrl(const QString &url);
 	static SessionsManager* getInstance();
 	static SessionModel* getModel();
@@ -274,18 +276,23 @@ protected:
 
 	void timerEvent(QTimerEvent *event) override;
 	void scheduleSave();
+	static void saveSnapshot();
+	static QString getSnapshotPath(const QString &path);
 
 private:
 	int m_saveTimer;
 
 	static SessionsManager *m_instance;
 	static SessionModel *m_model;
+	static SessionSnapshot *m_snapshot;
 	static QString m_sessionPath;
 	static QString m_sessionTitle;
 	static QString m_cachePath;
 	static QString m_profilePath;
 	static QHash<QString, Session::Identity> m_identities;
 	static QVector<Session::MainWindow> m_closedWindows;
+	static QSet<quint64> m_modifiedWindows;
+	static bool m_areAllWindowsModified;
 	static bool m_isDirty;
 	static bool m_isPrivate;
 	static bool m_isReadOnly;
@@ -20,14 +20,20 @@
 **************************************************************************/
 
 #include "SettingsManager.h"
+#include "Console.h"
+#include "HostOverridesIndex.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QMetaEnum>
+#include <QtCore/QReadLocker>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QVector>
+#include <QtCore/QWriteLocker>
 
 namespace Otter
 {
@@ -36,15 +42,42 @@ SettingsManager* SettingsManager::m_instance(nullptr);
 QString SettingsManager::m_globalPath;
 QString SettingsManager::m_overridePath;
 QVector<SettingsManager::OptionDefinition> SettingsManager::m_definitions;
+QVector<QString> SettingsManager::m_names;
+QVector<QVariant> SettingsManager::m_values;
+QHash<QString, QVariant> SettingsManager::m_options;
+QHash<QString, QHash<QString, QVariant> > SettingsManager::m_overrides;
+HostOverridesIndex SettingsManager::m_overridesIndex;
 QHash<QString, int> SettingsManager::m_customOptions;
+QReadWriteLock SettingsManager::m_optionsLock;
 int SettingsManager::m_identifierCounter(-1);
 int SettingsManager::m_optionIdentifierEnumerator(0);
-bool SettingsManager::m_hasWildcardedOverrides(false);
+int SettingsManager::m_optionsRevision(0);
+int SettingsManager::m_batchLevel(0);
+bool SettingsManager::m_hasModifiedOptions(false);
+bool SettingsManager::m_hasModifiedOverrides(false);
 
-SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
+SettingsManager::SettingsManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
 {
 }
 
+SettingsManager::~SettingsManager()
+{
+	saveOptions();
+}
+
+void SettingsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		saveOptions();
+	}
+}
+
 void SettingsManager::createInstance(const QString &path)
 {
 	if (m_instance)
@@ -59,6 +92,8 @@ void SettingsManager::createInstance(const QString &path)
 	m_identifierCounter = staticMetaObject.enumerator(m_optionIdentifierEnumerator).keyCount();
 
 	m_definitions.reserve(m_identifierCounter);
+	m_names.reserve(m_identifierCounter);
+	m_values.reserve(m_identifierCounter);
 
 	registerOption(AddressField_CompletionDisplayModeOption, EnumerationType, QLatin1String("compact"), {QLatin1String("compact"), QLatin1String("columns")});
 	registerOption(AddressField_CompletionModeOption, EnumerationType, QLatin1String("inlineAndPopup"), {QLatin1String("none"), QLatin1String("inline"), QLatin1String("popup"), QLatin1String("inlineAndPopup")});
@@ -128,6 +163,8 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Content_ZoomTextOnlyOption, BooleanType, false);
 	registerOption(ContentBlocking_EnableContentBlockingOption, BooleanType, true);
 	registerOption(ContentBlocking_IgnoreHostsOption, ListType, QStringList());
+	registerOption(ContentBlocking_MatchingEngineOption, EnumerationType, QLatin1String("automaton"), {QLatin1String("automaton"), QLatin1String("trie")});
+	registerOption(ContentBlocking_PendingRulesPolicyOption, EnumerationType, QLatin1String("keepPrevious"), {QLatin1String("keepPrevious"), QLatin1String("passThrough")});
 	registerOption(ContentBlocking_ProfilesOption, ListType, QStringList());
 	registerOption(History_BrowsingLimitAmountGlobalOption, IntegerType, 1000);
 	registerOption(History_BrowsingLimitAmountWindowOption, IntegerType, 50);
@@ -207,6 +244,7 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Security_CiphersOption, ListType, QStringList(QLatin1String("default")));
 	registerOption(Security_EnableFraudCheckingOption, BooleanType, true);
 	registerOption(Security_IgnoreSslErrorsOption, ListType, QStringList());
+	registerOption(Sessions_ConcurrentTabsLoadingLimitOption, IntegerType, 3);
 	registerOption(Sessions_DeferTabsLoadingOption, BooleanType, true);
 	registerOption(Sessions_OpenInExistingWindowOption, BooleanType, false);
 	registerOption(Sessions_OptionsExludedFromInheritingOption, ListType, QStringList(QLatin1String("Content/PageReloadTime")));
@@ -246,29 +284,206 @@ void SettingsManager::createInstance(const QString &path)
 	registerOption(Updates_LastCheckOption, StringType, QString());
 	registerOption(Updates_ServerUrlOption, StringType, QLatin1String("https://www.otter-browser.org/updates/update.json"));
 
-	const QStringList hosts(getOverrideHosts());
+	loadOptions();
+
+	connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, m_instance, &SettingsManager::saveOptions);
+}
+
+void SettingsManager::loadOptions()
+{
+	saveOptions();
+
+	const QSettings configuration(m_globalPath, QSettings::IniFormat);
+	const QStringList keys(configuration.allKeys());
+	QHash<QString, QVariant> options;
+	options.reserve(keys.count());
+
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		options[keys.at(i)] = configuration.value(keys.at(i));
+	}
+
+	QSettings overrides(m_overridePath, QSettings::IniFormat);
+	const QStringList hosts(overrides.childGroups());
+	QHash<QString, QHash<QString, QVariant> > overridesValues;
+	QHash<QString, QHash<int, QVariant> > overridesIdentifiers;
 
 	for (int i = 0; i < hosts.count(); ++i)
 	{
-		if (hosts.at(i).startsWith(QLatin1Char('*')))
+		overrides.beginGroup(hosts.at(i));
+
+		const QStringList overrideKeys(overrides.allKeys());
+		QHash<QString, QVariant> values;
+		values.reserve(overrideKeys.count());
+
+		for (int j = 0; j < overrideKeys.count(); ++j)
 		{
-			m_hasWildcardedOverrides = true;
+			const int identifier(getOptionIdentifier(overrideKeys.at(j)));
+			const QVariant value(convertValue(overrides.value(overrideKeys.at(j)), getOptionDefinition(identifier).type));
 
-			break;
+			values[overrideKeys.at(j)] = value;
+
+			if (identifier >= 0)
+			{
+				overridesIdentifiers[hosts.at(i)][identifier] = value;
+			}
+		}
+
+		overrides.endGroup();
+
+		if (!values.isEmpty())
+		{
+			overridesValues[hosts.at(i)] = values;
+		}
+	}
+
+	QWriteLocker locker(&m_optionsLock);
+
+	m_options = options;
+	m_overrides = overridesValues;
+	m_overridesIndex.clear();
+
+	QHash<QString, QHash<int, QVariant> >::const_iterator hostsIterator;
+
+	for (hostsIterator = overridesIdentifiers.constBegin(); hostsIterator != overridesIdentifiers.constEnd(); ++hostsIterator)
+	{
+		QHash<int, QVariant>::const_iterator valuesIterator;
+
+		for (valuesIterator = hostsIterator.value().constBegin(); valuesIterator != hostsIterator.value().constEnd(); ++valuesIterator)
+		{
+			m_overridesIndex.setValue(hostsIterator.key(), valuesIterator.key(), valuesIterator.value());
+		}
+	}
+
+	for (int i = 0; i < m_definitions.count(); ++i)
+	{
+		updateValue(i);
+	}
+
+	++m_optionsRevision;
+}
+
+void SettingsManager::saveOptions()
+{
+	if (m_instance && m_instance->m_saveTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_saveTimer);
+
+		m_instance->m_saveTimer = 0;
+	}
+
+	if (m_hasModifiedOptions)
+	{
+		QHash<QString, QVariant> options;
+		options.reserve(m_options.count());
+
+		QHash<QString, QVariant>::const_iterator iterator;
+
+		for (iterator = m_options.constBegin(); iterator != m_options.constEnd(); ++iterator)
+		{
+			options[iterator.key()] = serializeValue(iterator.value(), getOptionDefinition(getOptionIdentifier(iterator.key())).type);
+		}
+
+		if (writeOptions(m_globalPath, options))
+		{
+			m_hasModifiedOptions = false;
 		}
 	}
+
+	if (m_hasModifiedOverrides)
+	{
+		QHash<QString, QVariant> overrides;
+		QHash<QString, QHash<QString, QVariant> >::const_iterator hostsIterator;
+
+		for (hostsIterator = m_overrides.constBegin(); hostsIterator != m_overrides.constEnd(); ++hostsIterator)
+		{
+			QHash<QString, QVariant>::const_iterator valuesIterator;
+
+			for (valuesIterator = hostsIterator.value().constBegin(); valuesIterator != hostsIterator.value().constEnd(); ++valuesIterator)
+			{
+				overrides[hostsIterator.key() + QLatin1Char('/') + valuesIterator.key()] = serializeValue(valuesIterator.value(), getOptionDefinition(getOptionIdentifier(valuesIterator.key())).type);
+			}
+		}
+
+		if (writeOptions(m_overridePath, overrides))
+		{
+			m_hasModifiedOverrides = false;
+		}
+	}
+}
+
+void SettingsManager::beginBatch()
+{
+	++m_batchLevel;
+}
+
+void SettingsManager::endBatch()
+{
+	if (m_batchLevel > 0)
+	{
+		--m_batchLevel;
+	}
+
+	if (m_batchLevel == 0 && (m_hasModifiedOptions || m_hasModifiedOverrides))
+	{
+		scheduleSave();
+	}
+}
+
+void SettingsManager::scheduleSave()
+{
+	if (!m_instance || m_batchLevel > 0)
+	{
+		return;
+	}
+
+	if (m_instance->m_saveTimer != 0)
+	{
+		m_instance->killTimer(m_instance->m_saveTimer);
+	}
+
+	m_instance->m_saveTimer = m_instance->startTimer(1000);
 }
 
 void SettingsManager::removeOverride(const QString &host, int identifier)
 {
+	const QString name((identifier < 0) ? QString() : getOptionName(identifier));
+
+	m_optionsLock.lockForWrite();
+
+	QHash<QString, QHash<QString, QVariant> >::iterator hostIterator(m_overrides.find(host));
+
+	if (hostIterator == m_overrides.end() || (identifier >= 0 && !hostIterator.value().contains(name)))
+	{
+		m_optionsLock.unlock();
+
+		return;
+	}
+
 	if (identifier < 0)
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host);
+		m_overrides.erase(hostIterator);
+		m_overridesIndex.removeHost(host);
 	}
 	else
 	{
-		QSettings(m_overridePath, QSettings::IniFormat).remove(host + QLatin1Char('/') + getOptionName(identifier));
+		hostIterator.value().remove(name);
+
+		if (hostIterator.value().isEmpty())
+		{
+			m_overrides.erase(hostIterator);
+		}
+
+		m_overridesIndex.removeValue(host, identifier);
 	}
+
+	++m_optionsRevision;
+
+	m_optionsLock.unlock();
+
+	m_hasModifiedOverrides = true;
+
+	scheduleSave();
 }
 
 void SettingsManager::registerOption(int identifier, OptionType type, const QVariant &defaultValue, const QStringList &choices, OptionDefinition::OptionFlags flags)
@@ -280,58 +495,104 @@ void SettingsManager::registerOption(int identifier, OptionType type, const QVar
 	definition.flags = flags;
 	definition.identifier = identifier;
 
+	QString name(staticMetaObject.enumerator(m_optionIdentifierEnumerator).valueToKey(identifier));
+	name.chop(6);
+
+	QWriteLocker locker(&m_optionsLock);
+
 	m_definitions.append(definition);
+	m_names.append(name.replace(QLatin1Char('_'), QLatin1Char('/')));
+	m_values.append(defaultValue);
 }
 
-void SettingsManager::saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type)
+bool SettingsManager::writeOptions(const QString &path, const QHash<QString, QVariant> &options)
 {
-	if (value.isNull())
+	QSettings settings(path, QSettings::IniFormat);
+	settings.clear();
+
+	QHash<QString, QVariant>::const_iterator iterator;
+
+	for (iterator = options.constBegin(); iterator != options.constEnd(); ++iterator)
 	{
-		QSettings(path, QSettings::IniFormat).remove(key);
+		settings.setValue(iterator.key(), iterator.value());
 	}
-	else if (type == ColorType)
-	{
-		const QColor color(value.value<QColor>());
 
-		QSettings(path, QSettings::IniFormat).setValue(key, (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString()));
-	}
-	else
+	settings.sync();
+
+	if (settings.status() != QSettings::NoError || (!options.isEmpty() && QFileInfo(path).size() == 0))
 	{
-		QSettings(path, QSettings::IniFormat).setValue(key, value);
+		Console::addMessage(QCoreApplication::translate("main", "Failed to save settings"), Console::OtherCategory, Console::ErrorLevel, path);
+
+		return false;
 	}
+
+	return true;
+}
+
+void SettingsManager::updateValue(int identifier)
+{
+	const QHash<QString, QVariant>::const_iterator iterator(m_options.constFind(m_names.at(identifier)));
+
+	m_values[identifier] = ((iterator == m_options.constEnd()) ? m_definitions.at(identifier).defaultValue : convertValue(iterator.value(), m_definitions.at(identifier).type));
 }
 
 void SettingsManager::updateOptionDefinition(int identifier, const SettingsManager::OptionDefinition &definition)
 {
+	QWriteLocker locker(&m_optionsLock);
+
 	if (identifier >= 0 && identifier < m_definitions.count())
 	{
 		m_definitions[identifier].defaultValue = definition.defaultValue;
 		m_definitions[identifier].choices = definition.choices;
+
+		updateValue(identifier);
+
+		++m_optionsRevision;
 	}
 }
 
 void SettingsManager::setOption(int identifier, const QVariant &value, const QString &host)
 {
-	const QString name(getOptionName(identifier));
-	const OptionType type(getOptionDefinition(identifier).type);
+	if (identifier < 0 || identifier >= m_definitions.count())
+	{
+		return;
+	}
+
+	const QString name(m_names.at(identifier));
 
 	if (!host.isEmpty())
 	{
-		const QString overrideName(host + QLatin1Char('/') + name);
+		m_optionsLock.lockForWrite();
 
 		if (value.isNull())
 		{
-			QSettings(m_overridePath, QSettings::IniFormat).remove(overrideName);
+			QHash<QString, QHash<QString, QVariant> >::iterator hostIterator(m_overrides.find(host));
+
+			if (hostIterator != m_overrides.end())
+			{
+				hostIterator.value().remove(name);
+
+				if (hostIterator.value().isEmpty())
+				{
+					m_overrides.erase(hostIterator);
+				}
+			}
+
+			m_overridesIndex.removeValue(host, identifier);
 		}
 		else
 		{
-			saveOption(m_overridePath, overrideName, value, type);
+			m_overrides[host][name] = value;
+			m_overridesIndex.setValue(host, identifier, value);
 		}
 
-		if (!m_hasWildcardedOverrides && overrideName.startsWith(QLatin1Char('*')))
-		{
-			m_hasWildcardedOverrides = true;
-		}
+		++m_optionsRevision;
+
+		m_optionsLock.unlock();
+
+		m_hasModifiedOverrides = true;
+
+		scheduleSave();
 
 		emit m_instance->hostOptionChanged(identifier, value, host);
 
@@ -340,7 +601,26 @@ void SettingsManager::setOption(int identifier, const QVariant &value, const QSt
 
 	if (getOption(identifier) != value)
 	{
-		saveOption(m_globalPath, name, value, type);
+		m_optionsLock.lockForWrite();
+
+		if (value.isNull())
+		{
+			m_options.remove(name);
+		}
+		else
+		{
+			m_options[name] = value;
+		}
+
+		++m_optionsRevision;
+
+		updateValue(identifier);
+
+		m_optionsLock.unlock();
+
+		m_hasModifiedOptions = true;
+
+		scheduleSave();
 
 		emit m_instance->optionChanged(identifier, value);
 	}
@@ -405,30 +685,22 @@ QString SettingsManager::createReport()
 	stream << QLatin1String("Settings:\n");
 
 	QHash<QString, int> overridenValues;
-	QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
+	QHash<QString, QHash<QString, QVariant> >::const_iterator hostsIterator;
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
-	{
-		overrides.beginGroup(overridesGroups.at(i));
+	m_optionsLock.lockForRead();
 
-		const QStringList keys(overrides.allKeys());
+	for (hostsIterator = m_overrides.constBegin(); hostsIterator != m_overrides.constEnd(); ++hostsIterator)
+	{
+		QHash<QString, QVariant>::const_iterator valuesIterator;
 
-		for (int j = 0; j < keys.count(); ++j)
+		for (valuesIterator = hostsIterator.value().constBegin(); valuesIterator != hostsIterator.value().constEnd(); ++valuesIterator)
 		{
-			if (overridenValues.contains(keys.at(j)))
-			{
-				++overridenValues[keys.at(j)];
-			}
-			else
-			{
-				overridenValues[keys.at(j)] = 1;
-			}
+			++overridenValues[valuesIterator.key()];
 		}
-
-		overrides.endGroup();
 	}
 
+	m_optionsLock.unlock();
+
 	const QStringList options(getOptions());
 
 	for (int i = 0; i < options.count(); ++i)
@@ -472,6 +744,13 @@ QString SettingsManager::getOverridePath()
 
 QString SettingsManager::getOptionName(int identifier)
 {
+	QReadLocker locker(&m_optionsLock);
+
+	if (identifier >= 0 && identifier < m_names.count())
+	{
+		return m_names.at(identifier);
+	}
+
 	QString name(staticMetaObject.enumerator(m_optionIdentifierEnumerator).valueToKey(identifier));
 
 	if (!name.isEmpty())
@@ -486,79 +765,121 @@ QString SettingsManager::getOptionName(int identifier)
 
 QVariant SettingsManager::getOption(int identifier, const QString &host)
 {
+	QReadLocker locker(&m_optionsLock);
+
 	if (identifier < 0 || identifier >= m_definitions.count())
 	{
 		return {};
 	}
 
-	const QString name(getOptionName(identifier));
-
-	if (host.isEmpty())
+	if (!host.isEmpty() && !m_overridesIndex.isEmpty())
 	{
-		return QSettings(m_globalPath, QSettings::IniFormat).value(name, m_definitions.at(identifier).defaultValue);
+		const QVariant value(m_overridesIndex.getValue(host, identifier));
+
+		if (value.isValid())
+		{
+			return value;
+		}
 	}
 
-	const QString overrideName(host + QLatin1Char('/') + name);
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
+	return m_values.at(identifier);
+}
 
-	if (m_hasWildcardedOverrides && !overrides.contains(overrideName))
+QVariant SettingsManager::serializeValue(const QVariant &value, OptionType type)
+{
+	if (type == ColorType)
 	{
-		const QStringList hostParts(host.split(QLatin1Char('.')));
+		const QColor color(value.value<QColor>());
 
-		for (int i = 1; i < hostParts.count(); ++i)
-		{
-			const QString wildcardedName(QLatin1String("*.") + QStringList(hostParts.mid(i)).join(QLatin1Char('.')) + QLatin1Char('/') + name);
+		return (color.isValid() ? color.name(QColor::HexArgb).toUpper() : QString());
+	}
 
-			if (overrides.contains(wildcardedName))
-			{
-				return QSettings(m_overridePath, QSettings::IniFormat).value(wildcardedName, getOption(identifier));
-			}
-		}
+	return value;
+}
+
+QVariant SettingsManager::convertValue(const QVariant &value, OptionType type)
+{
+	switch (type)
+	{
+		case BooleanType:
+			return value.toBool();
+		case IntegerType:
+			return value.toInt();
+		case ListType:
+			return value.toStringList();
+		case EnumerationType:
+		case PasswordType:
+		case PathType:
+		case StringType:
+			return value.toString();
+		default:
+			break;
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).value(overrideName, getOption(identifier));
+	return (value.isValid() ? value : QVariant(QString()));
 }
 
 QStringList SettingsManager::getOptions()
 {
-	QStringList options;
-	options.reserve(m_definitions.count());
+	m_optionsLock.lockForRead();
 
-	for (int i = 0; i < m_definitions.count(); ++i)
-	{
-		options.append(getOptionName(i));
-	}
+	QStringList options(m_names.toList());
+
+	m_optionsLock.unlock();
 
 	options.sort();
 
 	return options;
 }
 
-QStringList SettingsManager::getOverrideHosts(int identifier)
+QVector<QVariant> SettingsManager::getHostOptions(const QString &host)
 {
-	if (identifier < 0)
+	QReadLocker locker(&m_optionsLock);
+	QVector<QVariant> options(m_values);
+
+	if (!host.isEmpty())
 	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups();
+		m_overridesIndex.resolveValues(host, options);
 	}
 
-	const QSettings overrides(m_overridePath, QSettings::IniFormat);
-	const QStringList overridesGroups(overrides.childGroups());
+	return options;
+}
+
+QStringList SettingsManager::getOverrideHosts(int identifier)
+{
+	const QString name((identifier < 0) ? QString() : getOptionName(identifier));
 	QStringList hosts;
-	const QString optionName(getOptionName(identifier));
 
-	for (int i = 0; i < overridesGroups.count(); ++i)
+	m_optionsLock.lockForRead();
+
+	if (identifier < 0)
+	{
+		hosts = m_overrides.keys();
+	}
+	else
 	{
-		if (overrides.contains(overridesGroups.at(i) + QLatin1Char('/') + optionName))
+		QHash<QString, QHash<QString, QVariant> >::const_iterator iterator;
+
+		for (iterator = m_overrides.constBegin(); iterator != m_overrides.constEnd(); ++iterator)
 		{
-			hosts.append(overridesGroups.at(i));
+			if (iterator.value().contains(name))
+			{
+				hosts.append(iterator.key());
+			}
 		}
 	}
 
+	m_optionsLock.unlock();
+
+	hosts.sort();
+
 	return hosts;
 }
 
 SettingsManager::OptionDefinition SettingsManager::getOptionDefinition(int identifier)
 {
+	QReadLocker locker(&m_optionsLock);
+
 	if (identifier >= 0 && identifier < m_definitions.count())
 	{
 		return m_definitions.at(identifier);
@@ -574,6 +895,7 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 		return -1;
 	}
 
+	QWriteLocker locker(&m_optionsLock);
 	const int identifier(m_identifierCounter);
 
 	++m_identifierCounter;
@@ -588,6 +910,26 @@ int SettingsManager::registerOption(const QString &name, OptionType type, const
 	m_customOptions[name] = identifier;
 
 	m_definitions.append(definition);
+	m_names.append(name);
+	m_values.append(defaultValue);
+
+	updateValue(identifier);
+
+	QHash<QString, QHash<QString, QVariant> >::iterator iterator;
+
+	for (iterator = m_overrides.begin(); iterator != m_overrides.end(); ++iterator)
+	{
+		const QHash<QString, QVariant>::iterator valueIterator(iterator.value().find(name));
+
+		if (valueIterator != iterator.value().end())
+		{
+			valueIterator.value() = convertValue(valueIterator.value(), type);
+
+			m_overridesIndex.setValue(iterator.key(), identifier, valueIterator.value());
+		}
+	}
+
+	++m_optionsRevision;
 
 	return identifier;
 }
@@ -602,22 +944,39 @@ int SettingsManager::getOptionIdentifier(const QString &name)
 		mutableName.append(QLatin1String("Option"));
 	}
 
-	if (m_customOptions.contains(name))
+	m_optionsLock.lockForRead();
+
+	const int identifier(m_customOptions.value(name, -1));
+
+	m_optionsLock.unlock();
+
+	if (identifier >= 0)
 	{
-		return m_customOptions[name];
+		return identifier;
 	}
 
 	return staticMetaObject.enumerator(m_optionIdentifierEnumerator).keyToValue(mutableName.toLatin1());
 }
 
+int SettingsManager::getOptionsRevision()
+{
+	QReadLocker locker(&m_optionsLock);
+
+	return m_optionsRevision;
+}
+
 bool SettingsManager::hasOverride(const QString &host, int identifier)
 {
-	if (identifier < 0)
+	const QString name((identifier < 0) ? QString() : getOptionName(identifier));
+	QReadLocker locker(&m_optionsLock);
+	const QHash<QString, QHash<QString, QVariant> >::const_iterator iterator(m_overrides.constFind(host));
+
+	if (iterator == m_overrides.constEnd())
 	{
-		return QSettings(m_overridePath, QSettings::IniFormat).childGroups().contains(host);
+		return false;
 	}
 
-	return QSettings(m_overridePath, QSettings::IniFormat).contains(host + QLatin1Char('/') + getOptionName(identifier));
+	return (identifier < 0 || iterator.value().contains(name));
 }
 
 }
@@ -23,12 +23,15 @@
 #define OTTER_SETTINGSMANAGER_H
 
 #include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QVariant>
 #include <QtGui/QIcon>
 
 namespace Otter
 {
 
+class HostOverridesIndex;
+
 class SettingsManager final : public QObject
 {
 	Q_OBJECT
@@ -104,6 +107,8 @@ public:
 		Content_ZoomTextOnlyOption,
 		ContentBlocking_EnableContentBlockingOption,
 		ContentBlocking_IgnoreHostsOption,
+		ContentBlocking_MatchingEngineOption,
+		ContentBlocking_PendingRulesPolicyOption,
 		ContentBlocking_ProfilesOption,
 		History_BrowsingLimitAmountGlobalOption,
 		History_BrowsingLimitAmountWindowOption,
@@ -183,6 +188,7 @@ public:
 		Security_CiphersOption,
 		Security_EnableFraudCheckingOption,
 		Security_IgnoreSslErrorsOption,
+		Sessions_ConcurrentTabsLoadingLimitOption,
 		Sessions_DeferTabsLoadingOption,
 		Sessions_OpenInExistingWindowOption,
 		Sessions_OptionsExludedFromInheritingOption,
@@ -303,6 +309,10 @@ public:
 	};
 
 	static void createInstance(const QString &path);
+	static void loadOptions();
+	static void saveOptions();
+	static void beginBatch();
+	static void endBatch();
 	static void removeOverride(const QString &host, int identifier = -1);
 	static void updateOptionDefinition(int identifier, const OptionDefinition &definition);
 	static void setOption(int identifier, const QVariant &value, const QString &host = {});
@@ -314,27 +324,46 @@ public:
 	static QString getOptionName(int identifier);
 	static QVariant getOption(int identifier, const QString &host = {});
 	static QStringList getOptions();
+	static QVector<QVariant> getHostOptions(const QString &host);
 	static QStringList getOverrideHosts(int identifier = -1);
 	static OptionDefinition getOptionDefinition(int identifier);
 	static int registerOption(const QString &name, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag));
 	static int getOptionIdentifier(const QString &name);
+	static int getOptionsRevision();
 	static bool hasOverride(const QString &host, int identifier = -1);
 
 protected:
 	explicit SettingsManager(QObject *parent);
+	~SettingsManager();
 
+	void timerEvent(QTimerEvent *event) override;
+	static void scheduleSave();
 	static void registerOption(int identifier, OptionType type, const QVariant &defaultValue = {}, const QStringList &choices = {}, OptionDefinition::OptionFlags flags = static_cast<OptionDefinition::OptionFlags>(OptionDefinition::IsEnabledFlag | OptionDefinition::IsVisibleFlag | OptionDefinition::IsBuiltInFlag));
-	static void saveOption(const QString &path, const QString &key, const QVariant &value, OptionType type);
+	static void updateValue(int identifier);
+	static QVariant convertValue(const QVariant &value, OptionType type);
+	static QVariant serializeValue(const QVariant &value, OptionType type);
+	static bool writeOptions(const QString &path, const QHash<QString, QVariant> &options);
 
 private:
+	int m_saveTimer;
+
 	static SettingsManager *m_instance;
 	static QString m_globalPath;
 	static QString m_overridePath;
 	static QVector<OptionDefinition> m_definitions;
+	static QVector<QString> m_names;
+	static QVector<QVariant> m_values;
+	static QHash<QString, QVariant> m_options;
+	static QHash<QString, QHash<QString, QVariant> > m_overrides;
+	static HostOverridesIndex m_overridesIndex;
 	static QHash<QString, int> m_customOptions;
+	static QReadWriteLock m_optionsLock;
 	static int m_identifierCounter;
 	static int m_optionIdentifierEnumerator;
-	static bool m_hasWildcardedOverrides;
+	static int m_optionsRevision;
+	static int m_batchLevel;
+	static bool m_hasModifiedOptions;
+	static bool m_hasModifiedOverrides;
 
 signals:
 	void optionChanged(int identifier, const QVariant &value);
@@ -0,0 +1,215 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "TextSearchIndex.h"
+
+#include <algorithm>
+
+namespace Otter
+{
+
+TextSearchIndex::TextSearchIndex() :
+	m_needsSorting(false)
+{
+}
+
+void TextSearchIndex::addDocument(quint64 identifier, const QString &text)
+{
+	if (m_documents.contains(identifier))
+	{
+		removeDocument(identifier);
+	}
+
+	const QStringList tokens(createTokens(text));
+
+	if (tokens.isEmpty())
+	{
+		return;
+	}
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		QHash<QString, QVector<quint64> >::iterator iterator(m_tokens.find(tokens.at(i)));
+
+		if (iterator == m_tokens.end())
+		{
+			iterator = m_tokens.insert(tokens.at(i), {});
+
+			m_needsSorting = true;
+		}
+
+		QVector<quint64> &identifiers(iterator.value());
+
+		if (identifiers.isEmpty() || identifiers.last() < identifier)
+		{
+			identifiers.append(identifier);
+		}
+		else
+		{
+			identifiers.insert(std::lower_bound(identifiers.begin(), identifiers.end(), identifier), identifier);
+		}
+	}
+
+	m_documents.insert(identifier, tokens);
+}
+
+void TextSearchIndex::removeDocument(quint64 identifier)
+{
+	const QStringList tokens(m_documents.take(identifier));
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		QHash<QString, QVector<quint64> >::iterator iterator(m_tokens.find(tokens.at(i)));
+
+		if (iterator == m_tokens.end())
+		{
+			continue;
+		}
+
+		QVector<quint64> &identifiers(iterator.value());
+		const QVector<quint64>::iterator identifierIterator(std::lower_bound(identifiers.begin(), identifiers.end(), identifier));
+
+		if (identifierIterator != identifiers.end() && *identifierIterator == identifier)
+		{
+			identifiers.erase(identifierIterator);
+		}
+
+		if (identifiers.isEmpty())
+		{
+			m_tokens.erase(iterator);
+
+			m_needsSorting = true;
+		}
+	}
+}
+
+void TextSearchIndex::clear()
+{
+	m_tokens.clear();
+	m_documents.clear();
+	m_sortedTokens.clear();
+
+	m_needsSorting = false;
+}
+
+QVector<quint64> TextSearchIndex::findDocuments(const QString &query)
+{
+	QStringList tokens(createTokens(query));
+
+	if (tokens.isEmpty())
+	{
+		return {};
+	}
+
+	if (m_needsSorting)
+	{
+		m_sortedTokens = m_tokens.keys();
+		m_sortedTokens.sort();
+
+		m_needsSorting = false;
+	}
+
+	std::sort(tokens.begin(), tokens.end(), [&](const QString &first, const QString &second)
+	{
+		return (first.length() > second.length());
+	});
+
+	QVector<quint64> identifiers(findPrefixedDocuments(tokens.first()));
+
+	for (int i = 1; i < tokens.count(); ++i)
+	{
+		const QString &prefix(tokens.at(i));
+
+		identifiers.erase(std::remove_if(identifiers.begin(), identifiers.end(), [&](quint64 identifier)
+		{
+			const QStringList documentTokens(m_documents.value(identifier));
+
+			for (int j = 0; j < documentTokens.count(); ++j)
+			{
+				if (documentTokens.at(j).startsWith(prefix))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}), identifiers.end());
+	}
+
+	return identifiers;
+}
+
+QVector<quint64> TextSearchIndex::findPrefixedDocuments(const QString &prefix) const
+{
+	QStringList::const_iterator iterator(std::lower_bound(m_sortedTokens.constBegin(), m_sortedTokens.constEnd(), prefix));
+	QVector<quint64> identifiers;
+
+	while (iterator != m_sortedTokens.constEnd() && iterator->startsWith(prefix))
+	{
+		identifiers.append(m_tokens.value(*iterator));
+
+		++iterator;
+	}
+
+	std::sort(identifiers.begin(), identifiers.end());
+
+	identifiers.erase(std::unique(identifiers.begin(), identifiers.end()), identifiers.end());
+
+	return identifiers;
+}
+
+QStringList TextSearchIndex::createTokens(const QString &text)
+{
+	const QString foldedText(text.toCaseFolded());
+	QStringList tokens;
+	int start(-1);
+
+	for (int i = 0; i <= foldedText.length(); ++i)
+	{
+		if (i < foldedText.length() && foldedText.at(i).isLetterOrNumber())
+		{
+			if (start < 0)
+			{
+				start = i;
+			}
+		}
+		else if (start >= 0)
+		{
+			tokens.append(foldedText.mid(start, (i - start)));
+
+			start = -1;
+		}
+	}
+
+	tokens.removeDuplicates();
+
+	return tokens;
+}
+
+int TextSearchIndex::getDocumentsAmount() const
+{
+	return m_documents.count();
+}
+
+bool TextSearchIndex::hasDocument(quint64 identifier) const
+{
+	return m_documents.contains(identifier);
+}
+
+}
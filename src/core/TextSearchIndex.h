@@ -0,0 +1,55 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_TEXTSEARCHINDEX_H
+#define OTTER_TEXTSEARCHINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class TextSearchIndex final
+{
+public:
+	TextSearchIndex();
+
+	void addDocument(quint64 identifier, const QString &text);
+	void removeDocument(quint64 identifier);
+	void clear();
+	QVector<quint64> findDocuments(const QString &query);
+	static QStringList createTokens(const QString &text);
+	int getDocumentsAmount() const;
+	bool hasDocument(quint64 identifier) const;
+
+protected:
+	QVector<quint64> findPrefixedDocuments(const QString &prefix) const;
+
+private:
+	QHash<QString, QVector<quint64> > m_tokens;
+	QHash<quint64, QStringList> m_documents;
+	QStringList m_sortedTokens;
+	bool m_needsSorting;
+};
+
+}
+
+#endif
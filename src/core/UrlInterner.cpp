@@ -0,0 +1,171 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "UrlInterner.h"
+#include "Utils.h"
+
+namespace Otter
+{
+
+QHash<QUrl, quint32> UrlInterner::m_identifiers;
+QHash<QUrl, quint32> UrlInterner::m_aliases;
+QVector<UrlInterner::InternedUrl> UrlInterner::m_urls;
+QVector<quint32> UrlInterner::m_freeIdentifiers;
+
+void UrlInterner::retainUrl(quint32 identifier)
+{
+	if (identifier > 0 && identifier <= static_cast<quint32>(m_urls.count()))
+	{
+		++m_urls[static_cast<int>(identifier - 1)].references;
+	}
+}
+
+void UrlInterner::releaseUrl(quint32 identifier)
+{
+	if (identifier == 0 || identifier > static_cast<quint32>(m_urls.count()))
+	{
+		return;
+	}
+
+	InternedUrl &internedUrl(m_urls[static_cast<int>(identifier - 1)]);
+
+	if (internedUrl.references <= 0 || --internedUrl.references > 0)
+	{
+		return;
+	}
+
+	m_identifiers.remove(internedUrl.url);
+
+	internedUrl = {};
+
+	if (!m_aliases.isEmpty())
+	{
+		m_aliases.clear();
+	}
+
+	if (identifier == static_cast<quint32>(m_urls.count()))
+	{
+		m_urls.removeLast();
+
+		while (!m_urls.isEmpty() && m_urls.last().url.isEmpty())
+		{
+			m_freeIdentifiers.removeOne(static_cast<quint32>(m_urls.count()));
+			m_urls.removeLast();
+		}
+
+		if (m_urls.isEmpty())
+		{
+			m_urls.squeeze();
+		}
+	}
+	else
+	{
+		m_freeIdentifiers.append(identifier);
+	}
+}
+
+quint32 UrlInterner::internUrl(const QUrl &url)
+{
+	QUrl normalizedUrl;
+	quint32 identifier(findUrl(url, &normalizedUrl));
+
+	if (identifier > 0 || normalizedUrl.isEmpty())
+	{
+		return identifier;
+	}
+
+	if (m_freeIdentifiers.isEmpty())
+	{
+		m_urls.append({});
+
+		identifier = static_cast<quint32>(m_urls.count());
+	}
+	else
+	{
+		identifier = m_freeIdentifiers.takeLast();
+	}
+
+	m_urls[static_cast<int>(identifier - 1)].url = normalizedUrl;
+	m_identifiers.insert(normalizedUrl, identifier);
+
+	return identifier;
+}
+
+quint32 UrlInterner::findUrl(const QUrl &url)
+{
+	return findUrl(url, nullptr);
+}
+
+quint32 UrlInterner::findUrl(const QUrl &url, QUrl *normalizedUrl)
+{
+	if (url.isEmpty())
+	{
+		return 0;
+	}
+
+	quint32 identifier(m_identifiers.value(url));
+
+	if (identifier == 0)
+	{
+		identifier = m_aliases.value(url);
+	}
+
+	if (identifier > 0)
+	{
+		return identifier;
+	}
+
+	const QUrl adjustedUrl(Utils::normalizeUrl(url));
+
+	if (normalizedUrl)
+	{
+		*normalizedUrl = adjustedUrl;
+	}
+
+	if (adjustedUrl == url)
+	{
+		return 0;
+	}
+
+	identifier = m_identifiers.value(adjustedUrl);
+
+	if (identifier > 0)
+	{
+		if (m_aliases.count() >= AliasesLimit)
+		{
+			m_aliases.clear();
+		}
+
+		m_aliases.insert(url, identifier);
+	}
+
+	return identifier;
+}
+
+QUrl UrlInterner::getUrl(quint32 identifier)
+{
+	return ((identifier > 0 && identifier <= static_cast<quint32>(m_urls.count())) ? m_urls.at(static_cast<int>(identifier - 1)).url : QUrl());
+}
+
+int UrlInterner::getUrlsAmount()
+{
+	return m_identifiers.count();
+}
+
+}
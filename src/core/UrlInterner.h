@@ -0,0 +1,63 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_URLINTERNER_H
+#define OTTER_URLINTERNER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class UrlInterner final
+{
+public:
+	static void retainUrl(quint32 identifier);
+	static void releaseUrl(quint32 identifier);
+	static quint32 internUrl(const QUrl &url);
+	static quint32 findUrl(const QUrl &url);
+	static QUrl getUrl(quint32 identifier);
+	static int getUrlsAmount();
+
+protected:
+	enum InternerLimit
+	{
+		AliasesLimit = 4096
+	};
+
+	struct InternedUrl final
+	{
+		QUrl url;
+		int references = 0;
+	};
+
+	static quint32 findUrl(const QUrl &url, QUrl *normalizedUrl);
+
+private:
+	static QHash<QUrl, quint32> m_identifiers;
+	static QHash<QUrl, quint32> m_aliases;
+	static QVector<InternedUrl> m_urls;
+	static QVector<quint32> m_freeIdentifiers;
+};
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "UrlPrefixIndex.h"
+
+#include <QtCore/QSet>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+void UrlPrefixIndex::addUrl(const QUrl &url)
+{
+	const QStringList forms(createForms(url));
+
+	for (int i = 0; i < forms.count(); ++i)
+	{
+		Item item;
+		item.form = forms.at(i);
+		item.url = url;
+
+		const QVector<Item>::iterator iterator(std::lower_bound(m_items.begin(), m_items.end(), item));
+
+		if (iterator == m_items.end() || iterator->form != item.form || iterator->url != url)
+		{
+			m_items.insert(iterator, item);
+		}
+	}
+}
+
+void UrlPrefixIndex::addUrls(const QVector<QUrl> &urls)
+{
+	if (urls.count() < 16)
+	{
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			addUrl(urls.at(i));
+		}
+
+		return;
+	}
+
+	const int amount(m_items.count());
+
+	m_items.reserve(amount + (urls.count() * 3));
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const QStringList forms(createForms(urls.at(i)));
+
+		for (int j = 0; j < forms.count(); ++j)
+		{
+			Item item;
+			item.form = forms.at(j);
+			item.url = urls.at(i);
+
+			m_items.append(item);
+		}
+	}
+
+	std::sort((m_items.begin() + amount), m_items.end());
+	std::inplace_merge(m_items.begin(), (m_items.begin() + amount), m_items.end());
+
+	m_items.erase(std::unique(m_items.begin(), m_items.end(), [&](const Item &first, const Item &second)
+	{
+		return (first.form == second.form && first.url == second.url);
+	}), m_items.end());
+}
+
+void UrlPrefixIndex::removeUrl(const QUrl &url)
+{
+	const QStringList forms(createForms(url));
+
+	for (int i = 0; i < forms.count(); ++i)
+	{
+		Item item;
+		item.form = forms.at(i);
+		item.url = url;
+
+		const QVector<Item>::iterator iterator(std::lower_bound(m_items.begin(), m_items.end(), item));
+
+		if (iterator != m_items.end() && iterator->form == item.form && iterator->url == url)
+		{
+			m_items.erase(iterator);
+		}
+	}
+}
+
+void UrlPrefixIndex::removeUrls(const QVector<QUrl> &urls)
+{
+	if (urls.count() < 16)
+	{
+		for (int i = 0; i < urls.count(); ++i)
+		{
+			removeUrl(urls.at(i));
+		}
+
+		return;
+	}
+
+	QSet<QUrl> removedUrls;
+	removedUrls.reserve(urls.count());
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		removedUrls.insert(urls.at(i));
+	}
+
+	m_items.erase(std::remove_if(m_items.begin(), m_items.end(), [&](const Item &item)
+	{
+		return removedUrls.contains(item.url);
+	}), m_items.end());
+}
+
+void UrlPrefixIndex::clear()
+{
+	m_items.clear();
+}
+
+QVector<UrlPrefixIndex::Item>::const_iterator UrlPrefixIndex::findFirst(const QString &prefix) const
+{
+	return std::lower_bound(m_items.constBegin(), m_items.constEnd(), prefix, [&](const Item &item, const QString &prefix)
+	{
+		return (item.form < prefix);
+	});
+}
+
+QVector<UrlPrefixIndex::Item>::const_iterator UrlPrefixIndex::findLast(const QString &prefix) const
+{
+	return std::upper_bound(m_items.constBegin(), m_items.constEnd(), prefix, [&](const QString &prefix, const Item &item)
+	{
+		return (QStringRef::compare(item.form.leftRef(prefix.length()), prefix) > 0);
+	});
+}
+
+QVector<QUrl> UrlPrefixIndex::findUrls(const QString &prefix) const
+{
+	const QString normalizedPrefix(prefix.toLower());
+	const QVector<Item>::const_iterator end(findLast(normalizedPrefix));
+	QVector<QUrl> urls;
+	QSet<QUrl> matchedUrls;
+
+	for (QVector<Item>::const_iterator iterator(findFirst(normalizedPrefix)); iterator != end; ++iterator)
+	{
+		if (!matchedUrls.contains(iterator->url))
+		{
+			matchedUrls.insert(iterator->url);
+
+			urls.append(iterator->url);
+		}
+	}
+
+	return urls;
+}
+
+QStringList UrlPrefixIndex::createForms(const QUrl &url)
+{
+	QStringList forms({url.toString().toLower()});
+	const QString schemelessForm(url.toString(QUrl::RemoveScheme).mid(2));
+
+	if (schemelessForm.isEmpty())
+	{
+		return forms;
+	}
+
+	forms.append(schemelessForm.toLower());
+
+	if (schemelessForm.startsWith(QLatin1String("www.")) && url.host().count(QLatin1Char('.')) > 1)
+	{
+		forms.append(schemelessForm.mid(4).toLower());
+	}
+
+	forms.removeDuplicates();
+
+	return forms;
+}
+
+int UrlPrefixIndex::getMatchesAmount(const QString &prefix) const
+{
+	const QString normalizedPrefix(prefix.toLower());
+
+	return static_cast<int>(std::distance(findFirst(normalizedPrefix), findLast(normalizedPrefix)));
+}
+
+}
@@ -0,0 +1,62 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_URLPREFIXINDEX_H
+#define OTTER_URLPREFIXINDEX_H
+
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class UrlPrefixIndex final
+{
+public:
+	void addUrl(const QUrl &url);
+	void addUrls(const QVector<QUrl> &urls);
+	void removeUrl(const QUrl &url);
+	void removeUrls(const QVector<QUrl> &urls);
+	void clear();
+	QVector<QUrl> findUrls(const QString &prefix) const;
+	static QStringList createForms(const QUrl &url);
+	int getMatchesAmount(const QString &prefix) const;
+
+protected:
+	struct Item final
+	{
+		QString form;
+		QUrl url;
+
+		bool operator<(const Item &other) const
+		{
+			return ((form == other.form) ? (url < other.url) : (form < other.form));
+		}
+	};
+
+	QVector<Item>::const_iterator findFirst(const QString &prefix) const;
+	QVector<Item>::const_iterator findLast(const QString &prefix) const;
+
+private:
+	QVector<Item> m_items;
+};
+
+}
+
+#endif
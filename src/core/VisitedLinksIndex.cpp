@@ -0,0 +1,192 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "VisitedLinksIndex.h"
+
+namespace Otter
+{
+
+VisitedLinksIndex::VisitedLinksIndex() :
+	m_isRebuilding(false),
+	m_isReady(false)
+{
+}
+
+void VisitedLinksIndex::addEntry(quint64 identifier, const QUrl &url)
+{
+	if (identifier == 0 || url.isEmpty())
+	{
+		return;
+	}
+
+	if (m_isRebuilding)
+	{
+		m_pendingEntries.append({identifier, url});
+	}
+	else
+	{
+		addFingerprint(&m_fingerprints, identifier, createFingerprint(url.toString(QUrl::FullyEncoded)));
+	}
+}
+
+void VisitedLinksIndex::removeEntry(quint64 identifier)
+{
+	if (m_isRebuilding)
+	{
+		m_pendingEntries.append({identifier, QUrl()});
+	}
+	else
+	{
+		removeFingerprint(&m_fingerprints, identifier);
+	}
+}
+
+void VisitedLinksIndex::clear()
+{
+	m_fingerprints = {};
+	m_pendingEntries.clear();
+	m_isRebuilding = false;
+}
+
+void VisitedLinksIndex::beginRebuild()
+{
+	m_pendingEntries.clear();
+	m_isRebuilding = true;
+}
+
+void VisitedLinksIndex::endRebuild(const Fingerprints &fingerprints)
+{
+	if (!m_isRebuilding)
+	{
+		return;
+	}
+
+	m_fingerprints = fingerprints;
+	m_isRebuilding = false;
+	m_isReady = true;
+
+	for (int i = 0; i < m_pendingEntries.count(); ++i)
+	{
+		if (m_pendingEntries.at(i).second.isEmpty())
+		{
+			removeEntry(m_pendingEntries.at(i).first);
+		}
+		else
+		{
+			addEntry(m_pendingEntries.at(i).first, m_pendingEntries.at(i).second);
+		}
+	}
+
+	m_pendingEntries.clear();
+}
+
+void VisitedLinksIndex::addFingerprint(Fingerprints *fingerprints, quint64 identifier, quint64 fingerprint)
+{
+	const QHash<quint64, quint64>::iterator iterator(fingerprints->entries.find(identifier));
+
+	if (iterator != fingerprints->entries.end())
+	{
+		if (iterator.value() == fingerprint)
+		{
+			return;
+		}
+
+		removeFingerprint(fingerprints, identifier);
+	}
+
+	fingerprints->entries.insert(identifier, fingerprint);
+
+	++fingerprints->amounts[fingerprint];
+}
+
+void VisitedLinksIndex::removeFingerprint(Fingerprints *fingerprints, quint64 identifier)
+{
+	const QHash<quint64, quint64>::iterator entriesIterator(fingerprints->entries.find(identifier));
+
+	if (entriesIterator == fingerprints->entries.end())
+	{
+		return;
+	}
+
+	const QHash<quint64, int>::iterator amountsIterator(fingerprints->amounts.find(entriesIterator.value()));
+
+	if (amountsIterator != fingerprints->amounts.end() && --amountsIterator.value() <= 0)
+	{
+		fingerprints->amounts.erase(amountsIterator);
+	}
+
+	fingerprints->entries.erase(entriesIterator);
+}
+
+VisitedLinksIndex::Fingerprints VisitedLinksIndex::createFingerprints(const QVector<QPair<quint64, QUrl> > &entries)
+{
+	Fingerprints fingerprints;
+	fingerprints.entries.reserve(entries.count());
+	fingerprints.amounts.reserve(entries.count());
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (entries.at(i).first > 0 && !entries.at(i).second.isEmpty())
+		{
+			addFingerprint(&fingerprints, entries.at(i).first, createFingerprint(entries.at(i).second.toString(QUrl::FullyEncoded)));
+		}
+	}
+
+	return fingerprints;
+}
+
+quint64 VisitedLinksIndex::createFingerprint(const QString &url)
+{
+	// FNV-1a over the address without its fragment and without the trailing slash of its path
+	int length(url.indexOf(QLatin1Char('#')));
+
+	if (length < 0)
+	{
+		length = url.length();
+	}
+
+	const int queryPosition(url.indexOf(QLatin1Char('?')));
+	const int pathEnd((queryPosition >= 0 && queryPosition < length) ? queryPosition : length);
+	quint64 fingerprint(14695981039346656037ULL);
+
+	for (int i = 0; i < length; ++i)
+	{
+		if (i == (pathEnd - 1) && url.at(i) == QLatin1Char('/'))
+		{
+			continue;
+		}
+
+		fingerprint ^= url.at(i).unicode();
+		fingerprint *= 1099511628211ULL;
+	}
+
+	return fingerprint;
+}
+
+bool VisitedLinksIndex::hasFingerprint(quint64 fingerprint) const
+{
+	return m_fingerprints.amounts.contains(fingerprint);
+}
+
+bool VisitedLinksIndex::isReady() const
+{
+	return m_isReady;
+}
+
+}
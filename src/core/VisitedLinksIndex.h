@@ -0,0 +1,65 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_VISITEDLINKSINDEX_H
+#define OTTER_VISITEDLINKSINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class VisitedLinksIndex final
+{
+public:
+	struct Fingerprints final
+	{
+		QHash<quint64, quint64> entries;
+		QHash<quint64, int> amounts;
+	};
+
+	VisitedLinksIndex();
+
+	void addEntry(quint64 identifier, const QUrl &url);
+	void removeEntry(quint64 identifier);
+	void clear();
+	void beginRebuild();
+	void endRebuild(const Fingerprints &fingerprints);
+	static Fingerprints createFingerprints(const QVector<QPair<quint64, QUrl> > &entries);
+	static quint64 createFingerprint(const QString &url);
+	bool hasFingerprint(quint64 fingerprint) const;
+	bool isReady() const;
+
+protected:
+	static void addFingerprint(Fingerprints *fingerprints, quint64 identifier, quint64 fingerprint);
+	static void removeFingerprint(Fingerprints *fingerprints, quint64 identifier);
+
+private:
+	Fingerprints m_fingerprints;
+	QVector<QPair<quint64, QUrl> > m_pendingEntries;
+	bool m_isRebuilding;
+	bool m_isReady;
+};
+
+}
+
+#endif
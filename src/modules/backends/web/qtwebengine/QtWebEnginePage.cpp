@@ -170,21 +170,21 @@ void QtWebEnginePage::handleLoadFinished()
 		if (m_widget)
 		{
 			const QUrl url(m_widget->getUrl());
-			const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
+			const QString styleSheet(ContentFiltersManager::getCosmeticFiltersStyleSheet(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), url));
 
-			if (!cosmeticFilters.rules.isEmpty() || !cosmeticFilters.exceptions.isEmpty())
+			if (!styleSheet.isEmpty())
 			{
 				QFile file(QLatin1String(":/modules/backends/web/qtwebengine/resources/hideElements.js"));
 
 				if (file.open(QIODevice::ReadOnly))
 				{
-					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(cosmeticFilters.exceptions), createJavaScriptList(cosmeticFilters.rules)));
+					runJavaScript(QString::fromLatin1(file.readAll()).arg(createJavaScriptList(styleSheet.split(QLatin1Char('\n'), QString::SkipEmptyParts))));
 
 					file.close();
 				}
 			}
 
-			const QStringList blockedRequests(m_widget->getBlockedElements());
+			const QStringList blockedRequests(m_widget->getBlockedElements().toList());
 
 			if (!blockedRequests.isEmpty())
 			{
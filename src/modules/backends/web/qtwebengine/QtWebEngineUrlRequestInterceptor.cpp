@@ -104,9 +104,9 @@ void QtWebEngineUrlRequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo
 
 			Console::addMessage(QCoreApplication::translate("main", "Request blocked by rule from profile %1:\n%2").arg(profile ? profile->getTitle() : QCoreApplication::translate("main", "(Unknown)"), result.rule), Console::NetworkCategory, Console::LogLevel, request.requestUrl().toString(), -1);
 
-			if (storeBlockedUrl && !m_blockedElements.contains(request.requestUrl().url()))
+			if (storeBlockedUrl)
 			{
-				m_blockedElements.append(request.requestUrl().url());
+				m_blockedElements.insert(request.requestUrl().adjusted(QUrl::RemoveFragment).toString(QUrl::FullyEncoded));
 			}
 
 			NetworkManager::ResourceInformation resource;
@@ -214,7 +214,7 @@ QVariant QtWebEngineUrlRequestInterceptor::getPageInformation(WebWidget::PageInf
 	return {};
 }
 
-QStringList QtWebEngineUrlRequestInterceptor::getBlockedElements() const
+QSet<QString> QtWebEngineUrlRequestInterceptor::getBlockedElements() const
 {
 	return m_blockedElements;
 }
@@ -38,7 +38,7 @@ public:
 	explicit QtWebEngineUrlRequestInterceptor(QtWebEngineWebWidget *parent);
 
 	void interceptRequest(QWebEngineUrlRequestInfo &request) override;
-	QStringList getBlockedElements() const;
+	QSet<QString> getBlockedElements() const;
 	QVector<NetworkManager::ResourceInformation> getBlockedRequests() const;
 
 protected:
@@ -53,7 +53,7 @@ private:
 	QtWebEngineWebWidget *m_widget;
 	QString m_acceptLanguage;
 	QString m_userAgent;
-	QStringList m_blockedElements;
+	QSet<QString> m_blockedElements;
 	QStringList m_unblockedHosts;
 	QVector<NetworkManager::ResourceInformation> m_blockedRequests;
 	QVector<int> m_contentBlockingProfiles;
@@ -1077,7 +1077,7 @@ void QtWebEngineWebWidget::notifyUrlChanged()
 	emit urlChanged((url.toString() == QLatin1String("about:blank")) ? m_page->requestedUrl() : url);
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void QtWebEngineWebWidget::notifyIconChanged()
@@ -1307,7 +1307,7 @@ void QtWebEngineWebWidget::setZoom(int zoom)
 	{
 		m_page->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
@@ -1603,7 +1603,7 @@ QDateTime QtWebEngineWebWidget::getLastUrlClickTime() const
 	return m_lastUrlClickTime;
 }
 
-QStringList QtWebEngineWebWidget::getBlockedElements() const
+QSet<QString> QtWebEngineWebWidget::getBlockedElements() const
 {
 	return m_requestInterceptor->getBlockedElements();
 }
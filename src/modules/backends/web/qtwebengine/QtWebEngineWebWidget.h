@@ -126,7 +126,7 @@ protected:
 	QWebEnginePage* getPage() const;
 	QString parsePosition(const QString &script, const QPoint &position) const;
 	QDateTime getLastUrlClickTime() const;
-	QStringList getBlockedElements() const;
+	QSet<QString> getBlockedElements() const;
 	QVector<LinkUrl> processLinks(const QVariantList &rawLinks) const;
 	bool canGoBack() const override;
 	bool canGoForward() const override;
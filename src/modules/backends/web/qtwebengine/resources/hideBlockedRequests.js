@@ -1,13 +1,10 @@
-let requests = [%1];
-let elements = Array.from(document.querySelectorAll('[src]'));
+let requests = new Set([%1]);
+let elements = document.querySelectorAll('[src]');
 
 for (let i = 0; i < elements.length; ++i)
 {
-	for (let j = 0; j < requests.length; ++j)
+	if (requests.has(elements[i].src.split('#')[0]))
 	{
-		if (elements[i].getAttribute('src').indexOf(requests[j]) > -1)
-		{
-			elements[i].style.cssText = 'display:none !important';
-		}
+		elements[i].style.cssText = 'display:none !important';
 	}
 }
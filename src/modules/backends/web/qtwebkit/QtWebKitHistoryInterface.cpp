@@ -30,27 +30,29 @@ QtWebKitHistoryInterface::QtWebKitHistoryInterface(QObject *parent) : QWebHistor
 
 void QtWebKitHistoryInterface::clear()
 {
-	m_urls.clear();
+	m_fingerprints.clear();
 }
 
 void QtWebKitHistoryInterface::addHistoryEntry(const QString &url)
 {
-	if (m_urls.contains(url))
+	const quint64 fingerprint(VisitedLinksIndex::createFingerprint(url));
+
+	if (m_fingerprints.contains(fingerprint))
 	{
 		return;
 	}
 
-	m_urls.append(url);
+	m_fingerprints.append(fingerprint);
 
-	if (m_urls.length() > 100)
+	if (m_fingerprints.count() > 100)
 	{
-		m_urls.removeAt(0);
+		m_fingerprints.removeFirst();
 	}
 }
 
 bool QtWebKitHistoryInterface::historyContains(const QString &url) const
 {
-	return (m_urls.contains(url) || HistoryManager::hasEntry(url));
+	return (m_fingerprints.contains(VisitedLinksIndex::createFingerprint(url)) || HistoryManager::isVisited(url));
 }
 
 }
@@ -20,7 +20,7 @@
 #ifndef OTTER_QTWEBKITHISTORYINTERFACE_H
 #define OTTER_QTWEBKITHISTORYINTERFACE_H
 
-#include <QtCore/QStringList>
+#include <QtCore/QVector>
 #include <QtWebKit/QWebHistoryInterface>
 
 namespace Otter
@@ -40,7 +40,7 @@ protected slots:
 	void clear();
 
 private:
-	QStringList m_urls;
+	QVector<quint64> m_fingerprints;
 };
 
 }
@@ -669,7 +669,7 @@ QNetworkReply* QtWebKitNetworkManager::createRequest(Operation operation, const
 
 				if (resourceType != NetworkManager::ScriptType && resourceType != NetworkManager::StyleSheetType)
 				{
-					m_blockedElements.append(request.url().url());
+					m_blockedElements.insert(request.url().adjusted(QUrl::RemoveFragment).url());
 				}
 
 				NetworkManager::ResourceInformation resource;
@@ -829,7 +829,7 @@ WebWidget::SslInformation QtWebKitNetworkManager::getSslInformation() const
 	return m_sslInformation;
 }
 
-QStringList QtWebKitNetworkManager::getBlockedElements() const
+QSet<QString> QtWebKitNetworkManager::getBlockedElements() const
 {
 	return m_blockedElements;
 }
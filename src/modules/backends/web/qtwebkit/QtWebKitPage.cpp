@@ -47,10 +47,28 @@ namespace Otter
 QtWebKitFrame::QtWebKitFrame(QWebFrame *frame, QtWebKitWebWidget *parent) : QObject(parent),
 	m_frame(frame),
 	m_widget(parent),
+	m_hideBlockedElementsTimer(0),
 	m_isDisplayingErrorPage(false)
 {
 	connect(frame, &QWebFrame::destroyed, this, &QtWebKitFrame::deleteLater);
 	connect(frame, &QWebFrame::loadFinished, this, &QtWebKitFrame::handleLoadFinished);
+
+	if (parent)
+	{
+		connect(parent, &QtWebKitWebWidget::requestBlocked, this, &QtWebKitFrame::handleRequestBlocked);
+	}
+}
+
+void QtWebKitFrame::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_hideBlockedElementsTimer)
+	{
+		killTimer(m_hideBlockedElementsTimer);
+
+		m_hideBlockedElementsTimer = 0;
+
+		hideBlockedElements();
+	}
 }
 
 void QtWebKitFrame::runUserScripts(const QUrl &url) const
@@ -63,18 +81,48 @@ void QtWebKitFrame::runUserScripts(const QUrl &url) const
 	}
 }
 
-void QtWebKitFrame::applyContentBlockingRules(const QStringList &rules, bool isHiding)
+void QtWebKitFrame::applyContentBlockingStyleSheet(const QString &styleSheet)
+{
+	if (styleSheet.isEmpty())
+	{
+		return;
+	}
+
+	QWebElement parentElement(m_frame->findFirstElement(QLatin1String("head")));
+
+	if (parentElement.isNull())
+	{
+		parentElement = m_frame->documentElement();
+	}
+
+	parentElement.appendInside(QLatin1String("<style></style>"));
+	parentElement.lastChild().setPlainText(styleSheet);
+}
+
+void QtWebKitFrame::hideBlockedElements()
 {
-	const QString value(isHiding ? QLatin1String("none !important") : QString());
-	const QWebElementCollection elements(m_frame->documentElement().findAll(rules.join(QLatin1Char(','))));
+	if (!m_widget)
+	{
+		return;
+	}
+
+	const QSet<QString> blockedElements(m_widget->getBlockedElements());
+
+	if (blockedElements.isEmpty())
+	{
+		return;
+	}
+
+	const QUrl baseUrl(m_frame->baseUrl());
+	const QWebElementCollection elements(m_frame->documentElement().findAll(QLatin1String("[src]")));
 
 	for (int i = 0; i < elements.count(); ++i)
 	{
 		QWebElement element(elements.at(i));
 
-		if (!element.isNull())
+		if (blockedElements.contains(baseUrl.resolved(QUrl(element.attribute(QLatin1String("src")))).adjusted(QUrl::RemoveFragment).url()))
 		{
-			element.setStyleProperty(QLatin1String("display"), value);
+			element.setStyleProperty(QLatin1String("display"), QLatin1String("none !important"));
 		}
 	}
 }
@@ -126,32 +174,23 @@ void QtWebKitFrame::handleLoadFinished()
 		return;
 	}
 
-	const ContentFiltersManager::CosmeticFiltersResult cosmeticFilters(ContentFiltersManager::getCosmeticFilters(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), m_widget->getUrl()));
-
-	applyContentBlockingRules(cosmeticFilters.rules, true);
-	applyContentBlockingRules(cosmeticFilters.exceptions, false);
-
-	const QStringList blockedRequests(m_widget->getBlockedElements());
+	applyContentBlockingStyleSheet(ContentFiltersManager::getCosmeticFiltersStyleSheet(ContentFiltersManager::getProfileIdentifiers(m_widget->getOption(SettingsManager::ContentBlocking_ProfilesOption).toStringList()), m_widget->getUrl()));
 
-	if (blockedRequests.count() > 0)
+	if (m_hideBlockedElementsTimer != 0)
 	{
-		const QWebElementCollection elements(m_frame->documentElement().findAll(QLatin1String("[src]")));
+		killTimer(m_hideBlockedElementsTimer);
 
-		for (int i = 0; i < elements.count(); ++i)
-		{
-			QWebElement element(elements.at(i));
-			const QUrl url(element.attribute(QLatin1String("src")));
+		m_hideBlockedElementsTimer = 0;
+	}
 
-			for (int j = 0; j < blockedRequests.count(); ++j)
-			{
-				if (url.matches(QUrl(blockedRequests.at(j)), QUrl::None) || blockedRequests.at(j).endsWith(url.url()))
-				{
-					element.setStyleProperty(QLatin1String("display"), QLatin1String("none !important"));
+	hideBlockedElements();
+}
 
-					break;
-				}
-			}
-		}
+void QtWebKitFrame::handleRequestBlocked(const NetworkManager::ResourceInformation &request)
+{
+	if (m_hideBlockedElementsTimer == 0 && request.resourceType != NetworkManager::ScriptType && request.resourceType != NetworkManager::StyleSheetType)
+	{
+		m_hideBlockedElementsTimer = startTimer(100);
 	}
 }
 
@@ -21,6 +21,7 @@
 #ifndef OTTER_QTWEBKITPAGE_H
 #define OTTER_QTWEBKITPAGE_H
 
+#include "../../../../core/NetworkManager.h"
 #include "../../../../core/SessionsManager.h"
 
 #include <QtWebKit/QWebElement>
@@ -48,14 +49,18 @@ public slots:
 	void handleIsDisplayingErrorPageChanged(QWebFrame *frame, bool isDisplayingErrorPage);
 
 protected:
-	void applyContentBlockingRules(const QStringList &rules, bool isHiding);
+	void timerEvent(QTimerEvent *event) override;
+	void applyContentBlockingStyleSheet(const QString &styleSheet);
+	void hideBlockedElements();
 
 protected slots:
 	void handleLoadFinished();
+	void handleRequestBlocked(const NetworkManager::ResourceInformation &request);
 
 private:
 	QWebFrame *m_frame;
 	QtWebKitWebWidget *m_widget;
+	int m_hideBlockedElementsTimer;
 	bool m_isDisplayingErrorPage;
 };
 
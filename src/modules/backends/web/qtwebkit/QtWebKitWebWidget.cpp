@@ -1531,7 +1531,7 @@ void QtWebKitWebWidget::handleHistory()
 			m_isTypedIn = false;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 		BookmarksManager::updateVisits(url.toString());
 	}
 }
@@ -1619,7 +1619,7 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 	emit arbitraryActionsStateChanged({ActionsManager::InspectPageAction, ActionsManager::InspectElementAction});
 	emit categorizedActionsStateChanged({ActionsManager::ActionDefinition::NavigationCategory, ActionsManager::ActionDefinition::PageCategory});
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void QtWebKitWebWidget::notifyIconChanged()
@@ -1863,7 +1863,7 @@ void QtWebKitWebWidget::setZoom(int zoom)
 	{
 		m_page->mainFrame()->setZoomFactor(qBound(0.1, (static_cast<qreal>(zoom) / 100), static_cast<qreal>(100)));
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 		emit geometryChanged();
@@ -2446,7 +2446,7 @@ WebWidget::HitTestResult QtWebKitWebWidget::getHitTestResult(const QPoint &posit
 	return result;
 }
 
-QStringList QtWebKitWebWidget::getBlockedElements() const
+QSet<QString> QtWebKitWebWidget::getBlockedElements() const
 {
 	return m_networkManager->getBlockedElements();
 }
@@ -65,7 +65,7 @@ public:
 	QString getActiveStyleSheet() const override;
 	QString getSelectedText() const override;
 	QVariant getPageInformation(PageInformation key) const override;
-	QStringList getBlockedElements() const;
+	QSet<QString> getBlockedElements() const;
 	QUrl getUrl() const override;
 	QIcon getIcon() const override;
 	QPixmap createThumbnail(const QSize &size = {}) override;
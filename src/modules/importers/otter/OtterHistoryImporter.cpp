@@ -0,0 +1,119 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "OtterHistoryImporter.h"
+#include "../../../core/HistoryManager.h"
+#include "../../../core/HistoryModel.h"
+#include "../../../core/SessionsManager.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+namespace Otter
+{
+
+OtterHistoryImporter::OtterHistoryImporter(QObject *parent) : Importer(parent)
+{
+}
+
+QWidget* OtterHistoryImporter::createOptionsWidget(QWidget *parent)
+{
+	Q_UNUSED(parent)
+
+	return nullptr;
+}
+
+QString OtterHistoryImporter::getName() const
+{
+	return QLatin1String("otter-history");
+}
+
+QString OtterHistoryImporter::getTitle() const
+{
+	return tr("Otter Browser History");
+}
+
+QString OtterHistoryImporter::getDescription() const
+{
+	return tr("Imports browsing history exported from Otter Browser");
+}
+
+QString OtterHistoryImporter::getVersion() const
+{
+	return QLatin1String("1.0");
+}
+
+QString OtterHistoryImporter::getSuggestedPath(const QString &path) const
+{
+	if (!path.isEmpty() && QFileInfo(path).isDir())
+	{
+		return QDir(path).filePath(QLatin1String("browsingHistory.json"));
+	}
+
+	return path;
+}
+
+QString OtterHistoryImporter::getGroup() const
+{
+	return QLatin1String("otter");
+}
+
+QUrl OtterHistoryImporter::getHomePage() const
+{
+	return QUrl(QLatin1String("https://otter-browser.org/"));
+}
+
+QStringList OtterHistoryImporter::getFileFilters() const
+{
+	return {tr("Otter Browser history files (*.json)")};
+}
+
+Importer::ImportType OtterHistoryImporter::getImportType() const
+{
+	return HistoryImport;
+}
+
+bool OtterHistoryImporter::import(const QString &path)
+{
+	HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+
+	if (SessionsManager::isReadOnly() || !model)
+	{
+		emit importFinished(HistoryImport, FailedImport, 0);
+
+		return false;
+	}
+
+	emit importStarted(HistoryImport, -1);
+
+	const int amount(model->rowCount());
+
+	if (!model->importEntries(getSuggestedPath(path)))
+	{
+		emit importFinished(HistoryImport, FailedImport, (model->rowCount() - amount));
+
+		return false;
+	}
+
+	emit importFinished(HistoryImport, SuccessfullImport, (model->rowCount() - amount));
+
+	return true;
+}
+
+}
@@ -30,6 +30,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeDatabase>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtWidgets/QFileIconProvider>
 
 namespace Otter
@@ -37,9 +38,17 @@ namespace Otter
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
 	m_types(NoCompletionType),
+	m_generation(0),
+	m_localPathsGeneration(0),
+	m_stage(StagesAmount),
+	m_stageTimer(0),
 	m_updateTimer(0),
+	m_isWaitingForLocalPaths(false),
 	m_showCompletionCategories(true)
 {
+	m_stagesSizes.fill(0, StagesAmount);
+
+	connect(&m_localPathsWatcher, &QFutureWatcher<LocalPathsListing>::finished, this, &AddressCompletionModel::handleLocalPathsListed);
 }
 
 void AddressCompletionModel::timerEvent(QTimerEvent *event)
@@ -53,165 +62,325 @@ void AddressCompletionModel::timerEvent(QTimerEvent *event)
 		if (!m_filter.isEmpty())
 		{
 			updateModel();
+		}
+	}
+	else if (event->timerId() == m_stageTimer)
+	{
+		processStage();
+
+		if (m_stage >= StagesAmount)
+		{
+			killTimer(m_stageTimer);
+
+			m_stageTimer = 0;
 
 			emit completionReady(m_filter);
 		}
 	}
 }
 
-void AddressCompletionModel::updateModel()
+void AddressCompletionModel::updateModel(bool isImmediate)
 {
-	QVector<CompletionEntry> completions;
-	completions.reserve(10);
-
-	if (m_types.testFlag(SearchSuggestionsCompletionType))
+	if (m_stageTimer != 0)
 	{
-		const QString keyword(m_filter.section(QLatin1Char(' '), 0, 0));
-		const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(keyword, true));
-		QString title(m_defaultSearchEngine.title);
-		QString text(m_filter);
-		QIcon icon(m_defaultSearchEngine.icon);
+		killTimer(m_stageTimer);
 
-		if (searchEngine.isValid())
-		{
-			title = searchEngine.title;
-			text = m_filter.section(QLatin1Char(' '), 1, -1);
-			icon = searchEngine.icon;
-		}
-		else if (keyword == QLatin1String("?"))
-		{
-			text = m_filter.section(QLatin1Char(' '), 1, -1);
-		}
+		m_stageTimer = 0;
+	}
 
-		if (icon.isNull())
-		{
-			icon = ThemesManager::createIcon(QLatin1String("edit-find"));
-		}
+	beginResetModel();
 
-		if (m_showCompletionCategories)
-		{
-			completions.append(CompletionEntry({}, tr("Search with %1").arg(title), {}, {}, {}, CompletionEntry::HeaderType));
+	++m_generation;
 
-			title.clear();
-		}
+	m_completions.clear();
+	m_stagesSizes.fill(0, StagesAmount);
+	m_stage = SearchSuggestionsStage;
+	m_isWaitingForLocalPaths = false;
 
-		CompletionEntry completionEntry({}, title, {}, icon, {}, CompletionEntry::SearchSuggestionType);
-		completionEntry.text = text;
-		completionEntry.keyword = keyword;
+	endResetModel();
 
-		completions.append(completionEntry);
+	if (isImmediate)
+	{
+		while (m_stage < StagesAmount)
+		{
+			processStage();
+		}
 	}
+	else
+	{
+		m_stageTimer = startTimer(0);
+	}
+}
 
-	if (m_types.testFlag(BookmarksCompletionType))
+void AddressCompletionModel::processStage()
+{
+	if (m_stage >= StagesAmount)
 	{
-		const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::findBookmarks(m_filter));
+		return;
+	}
 
-		if (m_showCompletionCategories && !bookmarks.isEmpty())
-		{
-			completions.append(CompletionEntry({}, tr("Bookmarks"), {}, {}, {}, CompletionEntry::HeaderType));
-		}
+	const CompletionStage stage(static_cast<CompletionStage>(m_stage));
+	QVector<CompletionEntry> completions;
 
-		for (int i = 0; i < bookmarks.count(); ++i)
-		{
-			CompletionEntry completionEntry(bookmarks.at(i).bookmark->getUrl(), bookmarks.at(i).bookmark->getTitle(), bookmarks.at(i).match, bookmarks.at(i).bookmark->getIcon(), {}, CompletionEntry::BookmarkType);
-			completionEntry.keyword = bookmarks.at(i).bookmark->getKeyword();
+	++m_stage;
 
-			if (completionEntry.keyword.startsWith(m_filter))
+	switch (stage)
+	{
+		case SearchSuggestionsStage:
+			if (m_types.testFlag(SearchSuggestionsCompletionType))
 			{
-				completionEntry.match = completionEntry.keyword;
+				const QString keyword(m_filter.section(QLatin1Char(' '), 0, 0));
+				const SearchEnginesManager::SearchEngineDefinition searchEngine(SearchEnginesManager::getSearchEngine(keyword, true));
+				QString title(m_defaultSearchEngine.title);
+				QString text(m_filter);
+				QIcon icon(m_defaultSearchEngine.icon);
+
+				if (searchEngine.isValid())
+				{
+					title = searchEngine.title;
+					text = m_filter.section(QLatin1Char(' '), 1, -1);
+					icon = searchEngine.icon;
+				}
+				else if (keyword == QLatin1String("?"))
+				{
+					text = m_filter.section(QLatin1Char(' '), 1, -1);
+				}
+
+				if (icon.isNull())
+				{
+					icon = ThemesManager::createIcon(QLatin1String("edit-find"));
+				}
+
+				if (m_showCompletionCategories)
+				{
+					completions.append(CompletionEntry({}, tr("Search with %1").arg(title), {}, {}, {}, CompletionEntry::HeaderType));
+
+					title.clear();
+				}
+
+				CompletionEntry completionEntry({}, title, {}, icon, {}, CompletionEntry::SearchSuggestionType);
+				completionEntry.text = text;
+				completionEntry.keyword = keyword;
+
+				completions.append(completionEntry);
 			}
 
-			completions.append(completionEntry);
-		}
-	}
+			break;
+		case BookmarksStage:
+			if (m_types.testFlag(BookmarksCompletionType))
+			{
+				const QVector<BookmarksModel::BookmarkMatch> bookmarks(BookmarksManager::findBookmarks(m_filter, StageCompletionsLimit));
 
-	if (m_types.testFlag(LocalPathSuggestionsCompletionType) && (m_filter == QString(QLatin1Char('~')) || m_filter.contains(QDir::separator())))
-	{
-		const QString directory((m_filter == QString(QLatin1Char('~'))) ? QDir::homePath() : m_filter.section(QDir::separator(), 0, -2) + QDir::separator());
-		const QString prefix(m_filter.contains(QDir::separator()) ? m_filter.section(QDir::separator(), -1, -1) : QString());
-		const QList<QFileInfo> entries(QDir(Utils::normalizePath(directory)).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot));
-		const QFileIconProvider iconProvider;
-		const QMimeDatabase mimeDatabase;
-		bool headerWasAdded(!m_showCompletionCategories);
-
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			if (entries.at(i).fileName().startsWith(prefix, Qt::CaseInsensitive))
+				if (m_showCompletionCategories && !bookmarks.isEmpty())
+				{
+					completions.append(CompletionEntry({}, tr("Bookmarks"), {}, {}, {}, CompletionEntry::HeaderType));
+				}
+
+				for (int i = 0; i < bookmarks.count(); ++i)
+				{
+					CompletionEntry completionEntry(bookmarks.at(i).bookmark->getUrl(), bookmarks.at(i).bookmark->getTitle(), bookmarks.at(i).match, bookmarks.at(i).bookmark->getIcon(), {}, CompletionEntry::BookmarkType);
+					completionEntry.keyword = bookmarks.at(i).bookmark->getKeyword();
+
+					if (completionEntry.keyword.startsWith(m_filter))
+					{
+						completionEntry.match = completionEntry.keyword;
+					}
+
+					completions.append(completionEntry);
+				}
+			}
+
+			break;
+		case LocalPathsStage:
+			if (m_types.testFlag(LocalPathSuggestionsCompletionType) && (m_filter == QString(QLatin1Char('~')) || m_filter.contains(QDir::separator())))
 			{
-				const QString path(directory + entries.at(i).fileName());
+				const QString directory((m_filter == QString(QLatin1Char('~'))) ? QDir::homePath() : m_filter.section(QDir::separator(), 0, -2) + QDir::separator());
 
-				if (!headerWasAdded)
+				if (m_localPathsListing.directory == directory)
+				{
+					completions = createLocalPathCompletions(m_localPathsListing);
+				}
+				else
 				{
-					completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
+					m_isWaitingForLocalPaths = true;
+					m_localPathsGeneration = m_generation;
+
+					if (!m_localPathsWatcher.isRunning() || m_localPathsDirectory != directory)
+					{
+						m_localPathsDirectory = directory;
+						m_localPathsWatcher.setFuture(QtConcurrent::run(&AddressCompletionModel::listLocalPaths, directory));
+					}
+				}
+			}
+
+			break;
+		case HistoryStage:
+			if (m_types.testFlag(HistoryCompletionType))
+			{
+				const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter, false, StageCompletionsLimit));
 
-					headerWasAdded = true;
+				if (m_showCompletionCategories && !entries.isEmpty())
+				{
+					completions.append(CompletionEntry({}, tr("History"), {}, {}, {}, CompletionEntry::HeaderType));
 				}
 
-				completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(path)), path, path, QIcon::fromTheme(mimeDatabase.mimeTypeForFile(entries.at(i), QMimeDatabase::MatchExtension).iconName(), iconProvider.icon(entries.at(i))), {}, CompletionEntry::LocalPathType));
+				for (int i = 0; i < entries.count(); ++i)
+				{
+					completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), (entries.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType)));
+				}
 			}
-		}
+
+			break;
+		case TypedHistoryStage:
+			if (m_types.testFlag(TypedHistoryCompletionType))
+			{
+				const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries({}, true));
+
+				if (m_showCompletionCategories && !entries.isEmpty())
+				{
+					completions.append(CompletionEntry({}, tr("Typed history"), {}, {}, {}, CompletionEntry::HeaderType));
+				}
+
+				for (int i = 0; i < entries.count(); ++i)
+				{
+					completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), CompletionEntry::TypedHistoryType, entries.at(i).entry->getIdentifier()));
+				}
+			}
+
+			break;
+		case SpecialPagesStage:
+			if (m_types.testFlag(SpecialPagesCompletionType))
+			{
+				const QStringList specialPages(AddonsManager::getSpecialPages());
+				bool headerWasAdded(!m_showCompletionCategories);
+
+				for (int i = 0; i < specialPages.count(); ++i)
+				{
+					const AddonsManager::SpecialPageInformation information(AddonsManager::getSpecialPage(specialPages.at(i)));
+
+					if (information.url.toString().startsWith(m_filter))
+					{
+						if (!headerWasAdded)
+						{
+							completions.append(CompletionEntry({}, tr("Special pages"), {}, {}, {}, CompletionEntry::HeaderType));
+
+							headerWasAdded = true;
+						}
+
+						completions.append(CompletionEntry(information.url, information.getTitle(), {}, information.icon, {}, CompletionEntry::SpecialPageType));
+					}
+				}
+			}
+
+			break;
+		default:
+			break;
 	}
 
-	if (m_types.testFlag(HistoryCompletionType))
+	setStageCompletions(stage, completions, m_generation);
+}
+
+void AddressCompletionModel::handleLocalPathsListed()
+{
+	const LocalPathsListing listing(m_localPathsWatcher.result());
+
+	m_localPathsListing = listing;
+
+	if (!m_isWaitingForLocalPaths || m_localPathsGeneration != m_generation || m_localPathsDirectory != listing.directory)
 	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries(m_filter));
+		return;
+	}
 
-		if (m_showCompletionCategories && !entries.isEmpty())
-		{
-			completions.append(CompletionEntry({}, tr("History"), {}, {}, {}, CompletionEntry::HeaderType));
-		}
+	m_isWaitingForLocalPaths = false;
 
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), (entries.at(i).isTypedIn ? CompletionEntry::TypedHistoryType : CompletionEntry::HistoryType)));
-		}
+	const QVector<CompletionEntry> completions(createLocalPathCompletions(listing));
+
+	setStageCompletions(LocalPathsStage, completions, m_localPathsGeneration);
+
+	if (!completions.isEmpty() && m_stage >= StagesAmount)
+	{
+		emit completionReady(m_filter);
+	}
+}
+
+void AddressCompletionModel::setStageCompletions(CompletionStage stage, const QVector<CompletionEntry> &completions, quint64 generation)
+{
+	if (completions.isEmpty() || generation != m_generation)
+	{
+		return;
 	}
 
-	if (m_types.testFlag(TypedHistoryCompletionType))
+	int row(0);
+
+	for (int i = 0; i < stage; ++i)
 	{
-		const QVector<HistoryModel::HistoryEntryMatch> entries(HistoryManager::findEntries({}, true));
+		row += m_stagesSizes.at(i);
+	}
 
-		if (m_showCompletionCategories && !entries.isEmpty())
-		{
-			completions.append(CompletionEntry({}, tr("Typed history"), {}, {}, {}, CompletionEntry::HeaderType));
-		}
+	beginInsertRows({}, row, (row + completions.count() - 1));
 
-		for (int i = 0; i < entries.count(); ++i)
-		{
-			completions.append(CompletionEntry(entries.at(i).entry->getUrl(), entries.at(i).entry->getTitle(), entries.at(i).match, entries.at(i).entry->getIcon(), entries.at(i).entry->getTimeVisited(), CompletionEntry::TypedHistoryType, entries.at(i).entry->getIdentifier()));
-		}
+	m_completions.insert(row, completions.count(), CompletionEntry());
+
+	for (int i = 0; i < completions.count(); ++i)
+	{
+		m_completions[row + i] = completions.at(i);
 	}
 
-	if (m_types.testFlag(SpecialPagesCompletionType))
+	m_stagesSizes[stage] = completions.count();
+
+	endInsertRows();
+}
+
+QVector<AddressCompletionModel::CompletionEntry> AddressCompletionModel::createLocalPathCompletions(const LocalPathsListing &listing) const
+{
+	const QString prefix(m_filter.contains(QDir::separator()) ? m_filter.section(QDir::separator(), -1, -1) : QString());
+	const QFileIconProvider iconProvider;
+	QVector<CompletionEntry> completions;
+	bool headerWasAdded(!m_showCompletionCategories);
+
+	for (int i = 0; i < listing.entries.count(); ++i)
 	{
-		const QStringList specialPages(AddonsManager::getSpecialPages());
-		bool headerWasAdded(!m_showCompletionCategories);
+		const QFileInfo &entry(listing.entries.at(i));
 
-		for (int i = 0; i < specialPages.count(); ++i)
+		if (entry.fileName().startsWith(prefix, Qt::CaseInsensitive))
 		{
-			const AddonsManager::SpecialPageInformation information(AddonsManager::getSpecialPage(specialPages.at(i)));
+			const QString path(listing.directory + entry.fileName());
 
-			if (information.url.toString().startsWith(m_filter))
+			if (!headerWasAdded)
 			{
-				if (!headerWasAdded)
-				{
-					completions.append(CompletionEntry({}, tr("Special pages"), {}, {}, {}, CompletionEntry::HeaderType));
+				completions.append(CompletionEntry({}, tr("Local files"), {}, {}, {}, CompletionEntry::HeaderType));
 
-					headerWasAdded = true;
-				}
+				headerWasAdded = true;
+			}
+
+			QIcon icon(QIcon::fromTheme(listing.iconNames.value(i)));
 
-				completions.append(CompletionEntry(information.url, information.getTitle(), {}, information.icon, {}, CompletionEntry::SpecialPageType));
+			if (icon.isNull())
+			{
+				icon = iconProvider.icon(entry);
 			}
+
+			completions.append(CompletionEntry(QUrl::fromLocalFile(QDir::toNativeSeparators(path)), path, path, icon, {}, CompletionEntry::LocalPathType));
 		}
 	}
 
-	completions.squeeze();
+	return completions;
+}
 
-	beginResetModel();
+AddressCompletionModel::LocalPathsListing AddressCompletionModel::listLocalPaths(const QString &directory)
+{
+	const QMimeDatabase mimeDatabase;
+	LocalPathsListing listing;
+	listing.directory = directory;
+	listing.entries = QDir(Utils::normalizePath(directory)).entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot).toVector();
+	listing.iconNames.reserve(listing.entries.count());
 
-	m_completions = completions;
+	for (int i = 0; i < listing.entries.count(); ++i)
+	{
+		listing.iconNames.append(mimeDatabase.mimeTypeForFile(listing.entries.at(i), QMimeDatabase::MatchExtension).iconName());
+	}
 
-	endResetModel();
+	return listing;
 }
 
 void AddressCompletionModel::setFilter(const QString &filter)
@@ -228,12 +397,26 @@ void AddressCompletionModel::setFilter(const QString &filter)
 			m_updateTimer = 0;
 		}
 
+		if (m_stageTimer != 0)
+		{
+			killTimer(m_stageTimer);
+
+			m_stageTimer = 0;
+		}
+
 		beginResetModel();
 
+		++m_generation;
+
 		m_completions.clear();
+		m_stagesSizes.fill(0, StagesAmount);
+		m_stage = StagesAmount;
+		m_isWaitingForLocalPaths = false;
 
 		endResetModel();
 
+		m_localPathsListing = {};
+
 		emit completionReady({});
 	}
 	else if (m_updateTimer == 0)
@@ -258,7 +441,7 @@ void AddressCompletionModel::setTypes(CompletionTypes types, bool force)
 			m_defaultSearchEngine = SearchEnginesManager::getSearchEngine();
 		}
 
-		updateModel();
+		updateModel(true);
 	}
 }
 
@@ -25,6 +25,8 @@
 #include "../../../core/SearchEnginesManager.h"
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -105,15 +107,54 @@ public slots:
 	void setFilter(const QString &filter = {});
 
 protected:
+	enum CompletionStage
+	{
+		SearchSuggestionsStage = 0,
+		BookmarksStage,
+		LocalPathsStage,
+		HistoryStage,
+		TypedHistoryStage,
+		SpecialPagesStage,
+		StagesAmount
+	};
+
+	enum CompletionLimit
+	{
+		StageCompletionsLimit = 25
+	};
+
+	struct LocalPathsListing final
+	{
+		QString directory;
+		QVector<QFileInfo> entries;
+		QStringList iconNames;
+	};
+
 	void timerEvent(QTimerEvent *event) override;
-	void updateModel();
+	void updateModel(bool isImmediate = false);
+	void setStageCompletions(CompletionStage stage, const QVector<CompletionEntry> &completions, quint64 generation);
+	QVector<CompletionEntry> createLocalPathCompletions(const LocalPathsListing &listing) const;
+	static LocalPathsListing listLocalPaths(const QString &directory);
+	void processStage();
+
+protected slots:
+	void handleLocalPathsListed();
 
 private:
+	QFutureWatcher<LocalPathsListing> m_localPathsWatcher;
 	QVector<CompletionEntry> m_completions;
+	QVector<int> m_stagesSizes;
 	QString m_filter;
+	QString m_localPathsDirectory;
+	LocalPathsListing m_localPathsListing;
 	SearchEnginesManager::SearchEngineDefinition m_defaultSearchEngine;
 	AddressCompletionModel::CompletionTypes m_types;
+	quint64 m_generation;
+	quint64 m_localPathsGeneration;
+	int m_stage;
+	int m_stageTimer;
 	int m_updateTimer;
+	bool m_isWaitingForLocalPaths;
 	bool m_showCompletionCategories;
 
 signals:
@@ -57,6 +57,16 @@ AddressDelegate::AddressDelegate(const QString &highlight, ViewMode mode, QObjec
 	connect(SettingsManager::getInstance(), &SettingsManager::optionChanged, this, &AddressDelegate::handleOptionChanged);
 }
 
+void AddressDelegate::setHighlight(const QString &highlight)
+{
+	m_highlight = highlight;
+}
+
+void AddressDelegate::setViewMode(ViewMode mode)
+{
+	m_viewMode = mode;
+}
+
 void AddressDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
 	QRect textRectangle(option.rect);
@@ -745,7 +755,20 @@ void AddressWidget::showCompletion(bool isTypedHistory)
 {
 	PopupViewWidget *popupWidget(getPopup());
 	popupWidget->setModel(m_completionModel);
-	popupWidget->setItemDelegate(new AddressDelegate((isTypedHistory ? QString() : text()), (isTypedHistory ? AddressDelegate::HistoryMode : AddressDelegate::CompletionMode), popupWidget));
+
+	const QString highlight(isTypedHistory ? QString() : text());
+	const AddressDelegate::ViewMode viewMode(isTypedHistory ? AddressDelegate::HistoryMode : AddressDelegate::CompletionMode);
+	AddressDelegate *delegate(qobject_cast<AddressDelegate*>(popupWidget->itemDelegate()));
+
+	if (delegate)
+	{
+		delegate->setHighlight(highlight);
+		delegate->setViewMode(viewMode);
+	}
+	else
+	{
+		popupWidget->setItemDelegate(new AddressDelegate(highlight, viewMode, popupWidget));
+	}
 
 	updateCompletion(isTypedHistory, isTypedHistory);
 
@@ -56,6 +56,8 @@ public:
 
 	explicit AddressDelegate(const QString &highlight, ViewMode mode, QObject *parent = nullptr);
 
+	void setHighlight(const QString &highlight);
+	void setViewMode(ViewMode mode);
 	void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 	QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
@@ -21,6 +21,7 @@
 #include "../../../core/Application.h"
 #include "../../../core/SessionsManager.h"
 #include "../../../core/SettingsManager.h"
+#include "../../../core/TextSearchIndex.h"
 #include "../../../core/ThemesManager.h"
 #include "../../../ui/Action.h"
 #include "../../../ui/BookmarkPropertiesDialog.h"
@@ -36,6 +37,8 @@
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QToolTip>
 
+#include <algorithm>
+
 namespace Otter
 {
 
@@ -71,10 +74,13 @@ BookmarksContentsWidget::BookmarksContentsWidget(const QVariantMap &parameters,
 	}
 
 	connect(BookmarksManager::getModel(), &BookmarksModel::modelReset, this, &BookmarksContentsWidget::updateActions);
+	connect(BookmarksManager::getModel(), &BookmarksModel::modelReset, this, &BookmarksContentsWidget::handleBookmarkModified);
+	connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkAdded, this, &BookmarksContentsWidget::handleBookmarkModified);
+	connect(BookmarksManager::getModel(), &BookmarksModel::bookmarkModified, this, &BookmarksContentsWidget::handleBookmarkModified);
 	connect(m_ui->propertiesButton, &QPushButton::clicked, this, &BookmarksContentsWidget::bookmarkProperties);
 	connect(m_ui->deleteButton, &QPushButton::clicked, this, &BookmarksContentsWidget::removeBookmark);
 	connect(m_ui->addButton, &QPushButton::clicked, this, &BookmarksContentsWidget::addBookmark);
-	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->bookmarksViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, &BookmarksContentsWidget::filterBookmarks);
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::doubleClicked, this, &BookmarksContentsWidget::openBookmark);
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::customContextMenuRequested, this, &BookmarksContentsWidget::showContextMenu);
 	connect(m_ui->bookmarksViewWidget, &ItemViewWidget::needsActionsUpdate, this, &BookmarksContentsWidget::updateActions);
@@ -146,6 +152,44 @@ void BookmarksContentsWidget::bookmarkProperties()
 	}
 }
 
+void BookmarksContentsWidget::filterBookmarks(const QString &filter)
+{
+	updateFilterMatches(filter);
+
+	m_ui->bookmarksViewWidget->setFilterString(filter);
+}
+
+void BookmarksContentsWidget::handleBookmarkModified()
+{
+	const QString filter(m_ui->filterLineEditWidget->text());
+
+	if (!filter.isEmpty())
+	{
+		updateFilterMatches(filter);
+
+		m_ui->bookmarksViewWidget->updateFilter();
+	}
+}
+
+void BookmarksContentsWidget::updateFilterMatches(const QString &filter)
+{
+	if (TextSearchIndex::createTokens(filter).isEmpty())
+	{
+		m_filterMatches.clear();
+
+		m_ui->bookmarksViewWidget->setFilterFunction(nullptr);
+
+		return;
+	}
+
+	m_filterMatches = BookmarksManager::searchBookmarks(filter);
+
+	m_ui->bookmarksViewWidget->setFilterFunction([&](const QModelIndex &index)
+	{
+		return std::binary_search(m_filterMatches.constBegin(), m_filterMatches.constEnd(), index.data(BookmarksModel::IdentifierRole).toULongLong());
+	});
+}
+
 void BookmarksContentsWidget::showContextMenu(const QPoint &position)
 {
 	const QModelIndex index(m_ui->bookmarksViewWidget->indexAt(position));
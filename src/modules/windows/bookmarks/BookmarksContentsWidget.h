@@ -65,6 +65,7 @@ protected:
 	void changeEvent(QEvent *event) override;
 	BookmarksModel::Bookmark* getBookmark(const QModelIndex &index) const;
 	BookmarkLocation getBookmarkCreationLocation();
+	void updateFilterMatches(const QString &filter);
 
 protected slots:
 	void addBookmark();
@@ -73,11 +74,14 @@ protected slots:
 	void removeBookmark();
 	void openBookmark();
 	void bookmarkProperties();
+	void filterBookmarks(const QString &filter);
+	void handleBookmarkModified();
 	void showContextMenu(const QPoint &position);
 	void updateActions();
 
 private:
 	ProxyModel *m_model;
+	QVector<quint64> m_filterMatches;
 	Ui::BookmarksContentsWidget *m_ui;
 };
 
@@ -366,6 +366,8 @@ void ConfigurationContentsWidget::saveAll(bool reset)
 		return;
 	}
 
+	SettingsManager::beginBatch();
+
 	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
 		const QModelIndex groupIndex(m_model->index(i, 0));
@@ -410,6 +412,8 @@ void ConfigurationContentsWidget::saveAll(bool reset)
 		}
 	}
 
+	SettingsManager::endBatch();
+
 	m_ui->configurationViewWidget->setModified(false);
 	m_ui->saveAllButton->setEnabled(false);
 
@@ -20,7 +20,6 @@
 #include "HistoryContentsWidget.h"
 #include "../../../core/Application.h"
 #include "../../../core/ThemesManager.h"
-#include "../../../core/Utils.h"
 #include "../../../ui/Action.h"
 #include "../../../ui/MainWindow.h"
 
@@ -35,44 +34,31 @@ namespace Otter
 {
 
 HistoryContentsWidget::HistoryContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent) : ContentsWidget(parameters, window, parent),
-	m_model(new QStandardItemModel(this)),
+	m_model(new HistoryEntriesModel(HistoryManager::getBrowsingHistoryModel(), this)),
 	m_isLoading(true),
 	m_ui(new Ui::HistoryContentsWidget)
 {
 	m_ui->setupUi(this);
 	m_ui->filterLineEditWidget->setClearOnEscape(true);
 
-	const QStringList groups({tr("Today"), tr("Yesterday"), tr("Earlier This Week"), tr("Previous Week"), tr("Earlier This Month"), tr("Earlier This Year"), tr("Older")});
-
-	for (int i = 0; i < groups.count(); ++i)
-	{
-		m_model->appendRow(new QStandardItem(ThemesManager::createIcon(QLatin1String("inode-directory")), groups.at(i)));
-	}
-
-	m_model->setHorizontalHeaderLabels({tr("Address"), tr("Title"), tr("Date")});
-	m_model->setHeaderData(0, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
-	m_model->setHeaderData(1, Qt::Horizontal, 300, HeaderViewWidget::WidthRole);
-	m_model->setSortRole(Qt::DisplayRole);
-
 	m_ui->historyViewWidget->setViewMode(ItemViewWidget::TreeView);
-	m_ui->historyViewWidget->setModel(m_model, true);
-	m_ui->historyViewWidget->setSortRoleMapping({{2, TimeVisitedRole}});
+	m_ui->historyViewWidget->setModel(m_model);
 	m_ui->historyViewWidget->installEventFilter(this);
 	m_ui->historyViewWidget->viewport()->installEventFilter(this);
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		m_ui->historyViewWidget->setRowHidden(i, m_model->invisibleRootItem()->index(), true);
-	}
+	updateGroups();
 
 	QTimer::singleShot(100, this, &HistoryContentsWidget::populateEntries);
 
 	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::cleared, this, &HistoryContentsWidget::populateEntries);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryAdded, this, &HistoryContentsWidget::handleEntryAdded);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryModified, this, &HistoryContentsWidget::handleEntryModified);
-	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::entryRemoved, this, &HistoryContentsWidget::handleEntryRemoved);
+	connect(HistoryManager::getBrowsingHistoryModel(), &HistoryModel::loaded, this, &HistoryContentsWidget::populateEntries);
+	connect(HistoryManager::getInstance(), &HistoryManager::dayChanged, m_model, &HistoryEntriesModel::updateGroups);
 	connect(HistoryManager::getInstance(), &HistoryManager::dayChanged, this, &HistoryContentsWidget::populateEntries);
-	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, m_ui->historyViewWidget, &ItemViewWidget::setFilterString);
+	connect(m_model, &HistoryEntriesModel::modelReset, this, &HistoryContentsWidget::updateGroups);
+	connect(m_model, &HistoryEntriesModel::layoutChanged, this, &HistoryContentsWidget::updateGroups);
+	connect(m_model, &HistoryEntriesModel::rowsInserted, this, &HistoryContentsWidget::handleRowsInserted);
+	connect(m_model, &HistoryEntriesModel::rowsRemoved, this, &HistoryContentsWidget::updateGroups);
+	connect(m_ui->filterLineEditWidget, &LineEditWidget::textChanged, this, &HistoryContentsWidget::filterEntries);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::doubleClicked, this, &HistoryContentsWidget::openEntry);
 	connect(m_ui->historyViewWidget, &ItemViewWidget::customContextMenuRequested, this, &HistoryContentsWidget::showContextMenu);
 }
@@ -89,8 +75,6 @@ void HistoryContentsWidget::changeEvent(QEvent *event)
 	if (event->type() == QEvent::LanguageChange)
 	{
 		m_ui->retranslateUi(this);
-
-		m_model->setHorizontalHeaderLabels({tr("Address"), tr("Title"), tr("Date")});
 	}
 }
 
@@ -121,51 +105,55 @@ void HistoryContentsWidget::print(QPrinter *printer)
 
 void HistoryContentsWidget::populateEntries()
 {
-	const QDate date(QDate::currentDate());
-	const QVector<QDate> dates({date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365)});
+	updateGroups();
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		QStandardItem *groupItem(m_model->item(i, 0));
+	const QString expandBranches(SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString());
 
-		if (groupItem)
-		{
-			groupItem->setData(dates.value(i, QDate()), GroupDateRole);
-			groupItem->removeRows(0, groupItem->rowCount());
-		}
+	if (expandBranches == QLatin1String("first"))
+	{
+		expandFirstGroup();
+	}
+	else if (expandBranches == QLatin1String("all"))
+	{
+		m_ui->historyViewWidget->expandAll();
 	}
 
-	const HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+	m_isLoading = false;
 
-	for (int i = 0; i < model->rowCount(); ++i)
+	emit loadingStateChanged(WebWidget::FinishedLoadingState);
+}
+
+void HistoryContentsWidget::updateGroups()
+{
+	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
-		handleEntryAdded(static_cast<HistoryModel::Entry*>(model->item(i, 0)));
+		m_ui->historyViewWidget->setRowHidden(i, {}, (m_model->rowCount(m_model->index(i, 0)) == 0));
 	}
 
-	const QString expandBranches(SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString());
+	if (m_model->isFiltered())
+	{
+		m_ui->historyViewWidget->expandAll();
+	}
+}
 
-	if (expandBranches == QLatin1String("first"))
+void HistoryContentsWidget::expandFirstGroup()
+{
+	for (int i = 0; i < m_model->rowCount(); ++i)
 	{
-		for (int i = 0; i < m_model->rowCount(); ++i)
-		{
-			const QModelIndex index(m_model->index(i, 0));
+		const QModelIndex index(m_model->index(i, 0));
 
-			if (m_model->rowCount(index) > 0)
-			{
-				m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
+		if (m_model->rowCount(index) > 0)
+		{
+			m_ui->historyViewWidget->expand(index);
 
-				break;
-			}
+			break;
 		}
 	}
-	else if (expandBranches == QLatin1String("all"))
-	{
-		m_ui->historyViewWidget->expandAll();
-	}
-
-	m_isLoading = false;
+}
 
-	emit loadingStateChanged(WebWidget::FinishedLoadingState);
+void HistoryContentsWidget::filterEntries(const QString &filter)
+{
+	m_model->setFilterString(filter);
 }
 
 void HistoryContentsWidget::removeEntry()
@@ -180,33 +168,24 @@ void HistoryContentsWidget::removeEntry()
 
 void HistoryContentsWidget::removeDomainEntries()
 {
-	const QStandardItem *domainItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	const HistoryModel::Entry *domainEntry(HistoryManager::getEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
 
-	if (!domainItem)
+	if (!domainEntry)
 	{
 		return;
 	}
 
-	const QString host(QUrl(domainItem->text()).host());
+	const HistoryModel *model(HistoryManager::getBrowsingHistoryModel());
+	const QString host(domainEntry->getUrl().host());
 	QVector<quint64> entries;
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
+	for (int i = 0; i < model->rowCount(); ++i)
 	{
-		const QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (!groupItem)
-		{
-			continue;
-		}
+		const HistoryModel::Entry *entry(static_cast<HistoryModel::Entry*>(model->item(i, 0)));
 
-		for (int j = (groupItem->rowCount() - 1); j >= 0; --j)
+		if (entry && host == entry->getUrl().host())
 		{
-			const QStandardItem *entryItem(groupItem->child(j, 0));
-
-			if (entryItem && host == QUrl(entryItem->text()).host())
-			{
-				entries.append(entryItem->data(IdentifierRole).toULongLong());
-			}
+			entries.append(entry->getIdentifier());
 		}
 	}
 
@@ -217,7 +196,7 @@ void HistoryContentsWidget::openEntry()
 {
 	const QModelIndex index(m_ui->historyViewWidget->currentIndex());
 
-	if (!index.isValid() || index.parent() == m_model->invisibleRootItem()->index())
+	if (!index.isValid() || !index.parent().isValid())
 	{
 		return;
 	}
@@ -238,124 +217,31 @@ void HistoryContentsWidget::openEntry()
 
 void HistoryContentsWidget::bookmarkEntry()
 {
-	const QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
+	const HistoryModel::Entry *entry(HistoryManager::getEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
 
-	if (entryItem)
+	if (entry)
 	{
-		Application::triggerAction(ActionsManager::BookmarkPageAction, {{QLatin1String("url"), entryItem->text()}, {QLatin1String("title"), m_ui->historyViewWidget->currentIndex().sibling(m_ui->historyViewWidget->currentIndex().row(), 1).data(Qt::DisplayRole).toString()}}, parentWidget());
+		Application::triggerAction(ActionsManager::BookmarkPageAction, {{QLatin1String("url"), entry->getUrl()}, {QLatin1String("title"), entry->getTitle()}}, parentWidget());
 	}
 }
 
 void HistoryContentsWidget::copyEntryLink()
 {
-	const QStandardItem *entryItem(findEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
-
-	if (entryItem)
-	{
-		QApplication::clipboard()->setText(entryItem->text());
-	}
-}
-
-void HistoryContentsWidget::handleEntryAdded(HistoryModel::Entry *entry)
-{
-	if (!entry || entry->getIdentifier() == 0 || findEntry(entry->getIdentifier()))
-	{
-		return;
-	}
-
-	QStandardItem *groupItem(nullptr);
+	const HistoryModel::Entry *entry(HistoryManager::getEntry(getEntry(m_ui->historyViewWidget->currentIndex())));
 
-	for (int i = 0; i < m_model->rowCount(); ++i)
+	if (entry)
 	{
-		groupItem = m_model->item(i, 0);
-
-		const QDate date(groupItem ? groupItem->data(GroupDateRole).toDate() : QDate());
-
-		if (!date.isValid() || entry->getTimeVisited().date() >= date)
-		{
-			break;
-		}
-
-		groupItem = nullptr;
-	}
-
-	if (!groupItem)
-	{
-		return;
-	}
-
-	QList<QStandardItem*> entryItems({new QStandardItem(entry->getIcon(), entry->getUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')))), new QStandardItem(entry->getTitle()), new QStandardItem(Utils::formatDateTime(entry->getTimeVisited()))});
-	entryItems[0]->setData(entry->getIdentifier(), IdentifierRole);
-	entryItems[0]->setFlags(entryItems[0]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[1]->setFlags(entryItems[1]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setData(entry->getTimeVisited(), TimeVisitedRole);
-	entryItems[2]->setFlags(entryItems[2]->flags() | Qt::ItemNeverHasChildren);
-	entryItems[2]->setToolTip(Utils::formatDateTime(entry->getTimeVisited(), {}, false));
-
-	groupItem->appendRow(entryItems);
-
-	m_ui->historyViewWidget->setRowHidden(groupItem->row(), groupItem->index().parent(), false);
-
-	if (sender() && groupItem->rowCount() == 1 && SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString() == QLatin1String("first"))
-	{
-		for (int i = 0; i < m_model->rowCount(); ++i)
-		{
-			const QModelIndex index(m_model->index(i, 0));
-
-			if (m_model->rowCount(index) > 0)
-			{
-				m_ui->historyViewWidget->expand(m_ui->historyViewWidget->getProxyModel()->mapFromSource(index));
-
-				break;
-			}
-		}
+		QApplication::clipboard()->setText(entry->getUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#'))));
 	}
 }
 
-void HistoryContentsWidget::handleEntryModified(HistoryModel::Entry *entry)
+void HistoryContentsWidget::handleRowsInserted(const QModelIndex &parent, int first, int last)
 {
-	if (!entry || entry->getIdentifier() == 0)
-	{
-		return;
-	}
-
-	QStandardItem *entryItem(findEntry(entry->getIdentifier()));
+	updateGroups();
 
-	if (!entryItem)
+	if (parent.isValid() && m_model->rowCount(parent) == (last - first + 1) && SettingsManager::getOption(SettingsManager::History_ExpandBranchesOption).toString() == QLatin1String("first"))
 	{
-		handleEntryAdded(entry);
-
-		return;
-	}
-
-	entryItem->setIcon(entry->getIcon());
-	entryItem->setText(entry->getUrl().toDisplayString());
-	entryItem->parent()->child(entryItem->row(), 1)->setText(entry->getTitle());
-	entryItem->parent()->child(entryItem->row(), 2)->setText(Utils::formatDateTime(entry->getTimeVisited()));
-}
-
-void HistoryContentsWidget::handleEntryRemoved(HistoryModel::Entry *entry)
-{
-	if (!entry || entry->getIdentifier() == 0)
-	{
-		return;
-	}
-
-	QStandardItem *entryItem(findEntry(entry->getIdentifier()));
-
-	if (entryItem)
-	{
-		QStandardItem *groupItem(entryItem->parent());
-
-		if (groupItem)
-		{
-			m_model->removeRow(entryItem->row(), groupItem->index());
-
-			if (groupItem->rowCount() == 0)
-			{
-				m_ui->historyViewWidget->setRowHidden(groupItem->row(), m_model->invisibleRootItem()->index(), true);
-			}
-		}
+		expandFirstGroup();
 	}
 }
 
@@ -385,29 +271,6 @@ void HistoryContentsWidget::showContextMenu(const QPoint &position)
 	menu.exec(m_ui->historyViewWidget->mapToGlobal(position));
 }
 
-QStandardItem* HistoryContentsWidget::findEntry(quint64 identifier)
-{
-	for (int i = 0; i < m_model->rowCount(); ++i)
-	{
-		const QStandardItem *groupItem(m_model->item(i, 0));
-
-		if (groupItem)
-		{
-			for (int j = 0; j < groupItem->rowCount(); ++j)
-			{
-				QStandardItem *entryItem(groupItem->child(j, 0));
-
-				if (entryItem && entryItem->data(IdentifierRole).toULongLong() == identifier)
-				{
-					return entryItem;
-				}
-			}
-		}
-	}
-
-	return nullptr;
-}
-
 QString HistoryContentsWidget::getTitle() const
 {
 	return tr("History");
@@ -435,7 +298,7 @@ WebWidget::LoadingState HistoryContentsWidget::getLoadingState() const
 
 quint64 HistoryContentsWidget::getEntry(const QModelIndex &index) const
 {
-	return ((index.isValid() && index.parent().isValid() && index.parent().parent() == m_model->invisibleRootItem()->index()) ? index.sibling(index.row(), 0).data(IdentifierRole).toULongLong() : 0);
+	return ((index.isValid() && index.parent().isValid()) ? index.sibling(index.row(), 0).data(HistoryEntriesModel::IdentifierRole).toULongLong() : 0);
 }
 
 bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
@@ -467,7 +330,7 @@ bool HistoryContentsWidget::eventFilter(QObject *object, QEvent *event)
 		{
 			const QModelIndex entryIndex(m_ui->historyViewWidget->currentIndex());
 
-			if (!entryIndex.isValid() || entryIndex.parent() == m_model->invisibleRootItem()->index())
+			if (!entryIndex.isValid() || !entryIndex.parent().isValid())
 			{
 				return ContentsWidget::eventFilter(object, event);
 			}
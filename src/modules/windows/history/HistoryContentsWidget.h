@@ -20,11 +20,10 @@
 #ifndef OTTER_HISTORYCONTENTSWIDGET_H
 #define OTTER_HISTORYCONTENTSWIDGET_H
 
+#include "HistoryEntriesModel.h"
 #include "../../../core/HistoryManager.h"
 #include "../../../ui/ContentsWidget.h"
 
-#include <QtGui/QStandardItemModel>
-
 namespace Otter
 {
 
@@ -40,13 +39,6 @@ class HistoryContentsWidget final : public ContentsWidget
 	Q_OBJECT
 
 public:
-	enum DataRole
-	{
-		IdentifierRole = Qt::UserRole,
-		TimeVisitedRole,
-		GroupDateRole
-	};
-
 	explicit HistoryContentsWidget(const QVariantMap &parameters, Window *window, QWidget *parent);
 	~HistoryContentsWidget();
 
@@ -63,23 +55,23 @@ public slots:
 
 protected:
 	void changeEvent(QEvent *event) override;
-	QStandardItem* findEntry(quint64 identifier);
+	void expandFirstGroup();
 	quint64 getEntry(const QModelIndex &index) const;
 
 protected slots:
 	void populateEntries();
+	void updateGroups();
+	void filterEntries(const QString &filter);
 	void removeEntry();
 	void removeDomainEntries();
 	void openEntry();
 	void bookmarkEntry();
 	void copyEntryLink();
-	void handleEntryAdded(HistoryModel::Entry *entry);
-	void handleEntryModified(HistoryModel::Entry *entry);
-	void handleEntryRemoved(HistoryModel::Entry *entry);
+	void handleRowsInserted(const QModelIndex &parent, int first, int last);
 	void showContextMenu(const QPoint &position);
 
 private:
-	QStandardItemModel *m_model;
+	HistoryEntriesModel *m_model;
 	bool m_isLoading;
 	Ui::HistoryContentsWidget *m_ui;
 };
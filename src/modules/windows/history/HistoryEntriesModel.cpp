@@ -0,0 +1,727 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "HistoryEntriesModel.h"
+#include "../../../core/HistoryManager.h"
+#include "../../../core/TextSearchIndex.h"
+#include "../../../core/ThemesManager.h"
+#include "../../../core/Utils.h"
+#include "../../../ui/ItemViewWidget.h"
+
+#include <algorithm>
+
+namespace Otter
+{
+
+HistoryEntriesModel::HistoryEntriesModel(HistoryModel *sourceModel, QObject *parent) : QAbstractItemModel(parent),
+	m_sourceModel(sourceModel),
+	m_sortOrder(Qt::DescendingOrder),
+	m_sortColumn(-1),
+	m_isMaterialized(false)
+{
+	updateGroups();
+
+	connect(m_sourceModel, &HistoryModel::modelReset, this, &HistoryEntriesModel::updateGroups);
+	connect(m_sourceModel, &HistoryModel::layoutChanged, this, &HistoryEntriesModel::updateGroups);
+	connect(m_sourceModel, &HistoryModel::loaded, this, [&]()
+	{
+		if (isFiltered())
+		{
+			updateLayout();
+		}
+	});
+	connect(m_sourceModel, &HistoryModel::entryAdded, this, &HistoryEntriesModel::handleEntryAdded);
+	connect(m_sourceModel, &HistoryModel::rowsAboutToBeRemoved, this, &HistoryEntriesModel::handleRowsAboutToBeRemoved);
+	connect(m_sourceModel, &HistoryModel::rowsRemoved, this, &HistoryEntriesModel::handleRowsRemoved);
+	connect(m_sourceModel, &HistoryModel::dataChanged, this, &HistoryEntriesModel::handleDataChanged);
+}
+
+void HistoryEntriesModel::sort(int column, Qt::SortOrder order)
+{
+	if (column == m_sortColumn && order == m_sortOrder)
+	{
+		return;
+	}
+
+	m_sortColumn = column;
+	m_sortOrder = order;
+
+	updateLayout();
+}
+
+void HistoryEntriesModel::updateGroups()
+{
+	beginResetModel();
+
+	const QDate date(QDate::currentDate());
+
+	m_dates = {date, date.addDays(-1), date.addDays(-7), date.addDays(-14), date.addDays(-30), date.addDays(-365), QDate()};
+	m_groupsSizes = calculateGroupsSizes();
+
+	updateOffsets();
+	materializeGroups();
+
+	endResetModel();
+}
+
+void HistoryEntriesModel::updateLayout()
+{
+	emit layoutAboutToBeChanged();
+
+	const QModelIndexList previousIndexes(persistentIndexList());
+	QVector<HistoryModel::Entry*> entries;
+	entries.reserve(previousIndexes.count());
+
+	for (int i = 0; i < previousIndexes.count(); ++i)
+	{
+		entries.append(getEntry(previousIndexes.at(i)));
+	}
+
+	m_groupsSizes = calculateGroupsSizes();
+
+	updateOffsets();
+	materializeGroups();
+
+	QModelIndexList indexes;
+	indexes.reserve(previousIndexes.count());
+
+	for (int i = 0; i < previousIndexes.count(); ++i)
+	{
+		const QModelIndex &previousIndex(previousIndexes.at(i));
+
+		if (previousIndex.parent().isValid())
+		{
+			const QModelIndex entryIndex(findEntry(entries.at(i)));
+
+			indexes.append(entryIndex.isValid() ? entryIndex.sibling(entryIndex.row(), previousIndex.column()) : QModelIndex());
+		}
+		else
+		{
+			indexes.append(previousIndex);
+		}
+	}
+
+	changePersistentIndexList(previousIndexes, indexes);
+
+	emit layoutChanged();
+}
+
+void HistoryEntriesModel::updateOffsets()
+{
+	int offset(0);
+
+	m_groupsOffsets.resize(m_groupsSizes.count());
+
+	for (int i = 0; i < m_groupsSizes.count(); ++i)
+	{
+		m_groupsOffsets[i] = offset;
+
+		offset += m_groupsSizes.at(i);
+	}
+}
+
+void HistoryEntriesModel::materializeGroups()
+{
+	m_groupsEntries.clear();
+
+	m_isMaterialized = needsMaterialization();
+
+	if (!m_isMaterialized)
+	{
+		return;
+	}
+
+	m_groupsEntries.resize(m_groupsSizes.count());
+
+	// The index only knows word tokens, so filters made of punctuation alone fall back to a substring scan
+	const bool hasFilterTokens(isFiltered() && !TextSearchIndex::createTokens(m_filterString).isEmpty());
+
+	if (hasFilterTokens)
+	{
+		const QVector<quint64> identifiers(HistoryManager::searchEntries(m_filterString));
+
+		for (int i = 0; i < identifiers.count(); ++i)
+		{
+			HistoryModel::Entry *entry(m_sourceModel->getEntry(identifiers.at(i)));
+
+			if (entry)
+			{
+				m_groupsEntries[findGroup(entry->getTimeVisited().date())].append(entry);
+			}
+		}
+
+		for (int i = 0; i < m_groupsEntries.count(); ++i)
+		{
+			std::stable_sort(m_groupsEntries[i].begin(), m_groupsEntries[i].end(), [&](HistoryModel::Entry *first, HistoryModel::Entry *second)
+			{
+				return (first->getTimeVisited() > second->getTimeVisited());
+			});
+		}
+	}
+	else
+	{
+		for (int i = 0; i < m_groupsSizes.count(); ++i)
+		{
+			QVector<HistoryModel::Entry*> &entries(m_groupsEntries[i]);
+			entries.reserve(m_groupsSizes.at(i));
+
+			for (int j = m_groupsOffsets.at(i); j < (m_groupsOffsets.at(i) + m_groupsSizes.at(i)); ++j)
+			{
+				HistoryModel::Entry *entry(static_cast<HistoryModel::Entry*>(m_sourceModel->item(j, 0)));
+
+				if (entry && (!isFiltered() || entry->getUrl().toDisplayString().contains(m_filterString, Qt::CaseInsensitive) || entry->getTitle().contains(m_filterString, Qt::CaseInsensitive)))
+				{
+					entries.append(entry);
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < m_groupsEntries.count(); ++i)
+	{
+		QVector<HistoryModel::Entry*> &entries(m_groupsEntries[i]);
+
+		if (m_sortColumn == 0 || m_sortColumn == 1)
+		{
+			QVector<QPair<QString, HistoryModel::Entry*> > sortedEntries;
+			sortedEntries.reserve(entries.count());
+
+			for (int j = 0; j < entries.count(); ++j)
+			{
+				sortedEntries.append({((m_sortColumn == 0) ? entries.at(j)->getUrl().toDisplayString() : entries.at(j)->getTitle()), entries.at(j)});
+			}
+
+			std::stable_sort(sortedEntries.begin(), sortedEntries.end(), [&](const QPair<QString, HistoryModel::Entry*> &first, const QPair<QString, HistoryModel::Entry*> &second)
+			{
+				const int result(first.first.compare(second.first, Qt::CaseInsensitive));
+
+				return ((m_sortOrder == Qt::AscendingOrder) ? (result < 0) : (result > 0));
+			});
+
+			for (int j = 0; j < sortedEntries.count(); ++j)
+			{
+				entries[j] = sortedEntries.at(j).second;
+			}
+		}
+		else if (m_sortColumn == 2 && m_sortOrder == Qt::AscendingOrder)
+		{
+			std::reverse(entries.begin(), entries.end());
+		}
+	}
+}
+
+void HistoryEntriesModel::handleEntryAdded(HistoryModel::Entry *entry)
+{
+	if (!entry)
+	{
+		return;
+	}
+
+	if (m_isMaterialized)
+	{
+		updateLayout();
+
+		return;
+	}
+
+	const QVector<int> sizes(calculateGroupsSizes());
+	int group(-1);
+
+	for (int i = 0; i < sizes.count(); ++i)
+	{
+		const int difference(sizes.at(i) - m_groupsSizes.value(i));
+
+		if (difference == 0)
+		{
+			continue;
+		}
+
+		if (difference != 1 || group >= 0)
+		{
+			updateLayout();
+
+			return;
+		}
+
+		group = i;
+	}
+
+	if (group < 0)
+	{
+		return;
+	}
+
+	const int row(entry->row() - m_groupsOffsets.at(group));
+
+	if (row < 0 || row > m_groupsSizes.at(group))
+	{
+		updateLayout();
+
+		return;
+	}
+
+	beginInsertRows(index(group, 0), row, row);
+
+	m_groupsSizes = sizes;
+
+	updateOffsets();
+
+	endInsertRows();
+}
+
+void HistoryEntriesModel::handleRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+	Q_UNUSED(first)
+	Q_UNUSED(last)
+
+	if (!parent.isValid() && m_isMaterialized)
+	{
+		beginResetModel();
+	}
+}
+
+void HistoryEntriesModel::handleRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+	if (parent.isValid())
+	{
+		return;
+	}
+
+	if (m_isMaterialized)
+	{
+		m_groupsSizes = calculateGroupsSizes();
+
+		updateOffsets();
+		materializeGroups();
+
+		endResetModel();
+
+		return;
+	}
+
+	QVector<QPair<int, int> > ranges;
+	ranges.reserve(m_groupsSizes.count());
+
+	for (int i = 0; i < m_groupsSizes.count(); ++i)
+	{
+		const int offset(m_groupsOffsets.at(i));
+
+		ranges.append({(qMax(first, offset) - offset), (qMin(last, (offset + m_groupsSizes.at(i) - 1)) - offset)});
+	}
+
+	for (int i = 0; i < ranges.count(); ++i)
+	{
+		const QPair<int, int> range(ranges.at(i));
+
+		if (range.first > range.second)
+		{
+			continue;
+		}
+
+		beginRemoveRows(index(i, 0), range.first, range.second);
+
+		m_groupsSizes[i] -= (range.second - range.first + 1);
+
+		updateOffsets();
+
+		endRemoveRows();
+	}
+}
+
+void HistoryEntriesModel::handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+	if (topLeft.parent().isValid())
+	{
+		return;
+	}
+
+	if (m_isMaterialized)
+	{
+		for (int i = 0; i < m_groupsEntries.count(); ++i)
+		{
+			if (!m_groupsEntries.at(i).isEmpty())
+			{
+				const QModelIndex groupIndex(index(i, 0));
+
+				emit dataChanged(index(0, 0, groupIndex), index((m_groupsEntries.at(i).count() - 1), (columnCount() - 1), groupIndex));
+			}
+		}
+
+		return;
+	}
+
+	for (int i = topLeft.row(); i <= bottomRight.row(); ++i)
+	{
+		const int group(findGroup(i));
+
+		if (group >= 0)
+		{
+			const QModelIndex groupIndex(index(group, 0));
+			const int row(i - m_groupsOffsets.at(group));
+
+			emit dataChanged(index(row, 0, groupIndex), index(row, (columnCount() - 1), groupIndex));
+		}
+	}
+}
+
+void HistoryEntriesModel::setFilterString(const QString &filter)
+{
+	if (filter != m_filterString)
+	{
+		m_filterString = filter;
+
+		updateLayout();
+	}
+}
+
+HistoryModel::Entry* HistoryEntriesModel::getEntry(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return nullptr;
+	}
+
+	const int group(static_cast<int>(index.internalId() - 1));
+
+	if (group >= m_groupsSizes.count())
+	{
+		return nullptr;
+	}
+
+	if (m_isMaterialized)
+	{
+		const QVector<HistoryModel::Entry*> &entries(m_groupsEntries.at(group));
+
+		return ((index.row() < entries.count()) ? entries.at(index.row()) : nullptr);
+	}
+
+	if (index.row() >= m_groupsSizes.at(group))
+	{
+		return nullptr;
+	}
+
+	return static_cast<HistoryModel::Entry*>(m_sourceModel->item(mapToSourceRow(group, index.row()), 0));
+}
+
+QModelIndex HistoryEntriesModel::findEntry(HistoryModel::Entry *entry) const
+{
+	if (!entry)
+	{
+		return {};
+	}
+
+	if (m_isMaterialized)
+	{
+		for (int i = 0; i < m_groupsEntries.count(); ++i)
+		{
+			const int row(m_groupsEntries.at(i).indexOf(entry));
+
+			if (row >= 0)
+			{
+				return index(row, 0, index(i, 0));
+			}
+		}
+
+		return {};
+	}
+
+	const int sourceRow(entry->row());
+	const int group(findGroup(sourceRow));
+
+	return ((group >= 0) ? index((sourceRow - m_groupsOffsets.at(group)), 0, index(group, 0)) : QModelIndex());
+}
+
+QModelIndex HistoryEntriesModel::index(int row, int column, const QModelIndex &parent) const
+{
+	if (!hasIndex(row, column, parent))
+	{
+		return {};
+	}
+
+	return createIndex(row, column, (parent.isValid() ? static_cast<quintptr>(parent.row() + 1) : static_cast<quintptr>(0)));
+}
+
+QModelIndex HistoryEntriesModel::parent(const QModelIndex &index) const
+{
+	if (!index.isValid() || index.internalId() == 0)
+	{
+		return {};
+	}
+
+	return createIndex(static_cast<int>(index.internalId() - 1), 0, static_cast<quintptr>(0));
+}
+
+QVariant HistoryEntriesModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+	{
+		return {};
+	}
+
+	if (index.internalId() == 0)
+	{
+		if (index.column() != 0)
+		{
+			return {};
+		}
+
+		switch (role)
+		{
+			case Qt::DisplayRole:
+				switch (index.row())
+				{
+					case 0:
+						return tr("Today");
+					case 1:
+						return tr("Yesterday");
+					case 2:
+						return tr("Earlier This Week");
+					case 3:
+						return tr("Previous Week");
+					case 4:
+						return tr("Earlier This Month");
+					case 5:
+						return tr("Earlier This Year");
+					default:
+						return tr("Older");
+				}
+			case Qt::DecorationRole:
+				return ThemesManager::createIcon(QLatin1String("inode-directory"));
+			case GroupDateRole:
+				return m_dates.value(index.row());
+			default:
+				return {};
+		}
+	}
+
+	const HistoryModel::Entry *entry(getEntry(index));
+
+	if (!entry)
+	{
+		return {};
+	}
+
+	switch (role)
+	{
+		case Qt::DisplayRole:
+			switch (index.column())
+			{
+				case 0:
+					return entry->getUrl().toDisplayString().replace(QLatin1String("%23"), QString(QLatin1Char('#')));
+				case 1:
+					return entry->getTitle();
+				case 2:
+					return Utils::formatDateTime(entry->getTimeVisited());
+				default:
+					break;
+			}
+
+			break;
+		case Qt::DecorationRole:
+			if (index.column() == 0)
+			{
+				return entry->getIcon();
+			}
+
+			break;
+		case Qt::ToolTipRole:
+			if (index.column() == 2)
+			{
+				return Utils::formatDateTime(entry->getTimeVisited(), {}, false);
+			}
+
+			break;
+		case IdentifierRole:
+			return entry->getIdentifier();
+		case TimeVisitedRole:
+			return entry->getTimeVisited();
+		default:
+			break;
+	}
+
+	return {};
+}
+
+QVariant HistoryEntriesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal)
+	{
+		switch (role)
+		{
+			case Qt::DisplayRole:
+				switch (section)
+				{
+					case 0:
+						return tr("Address");
+					case 1:
+						return tr("Title");
+					case 2:
+						return tr("Date");
+					default:
+						break;
+				}
+
+				break;
+			case HeaderViewWidget::WidthRole:
+				if (section == 0 || section == 1)
+				{
+					return 300;
+				}
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	return QAbstractItemModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags HistoryEntriesModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
+
+	if (index.internalId() == 0)
+	{
+		return (Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+	}
+
+	return (Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemNeverHasChildren);
+}
+
+QVector<int> HistoryEntriesModel::calculateGroupsSizes() const
+{
+	const int rowCount(m_sourceModel->rowCount());
+	QVector<int> sizes;
+	sizes.reserve(m_dates.count());
+
+	int start(0);
+
+	for (int i = 0; i < m_dates.count(); ++i)
+	{
+		int end(rowCount);
+
+		if (m_dates.at(i).isValid())
+		{
+			int low(start);
+			int high(rowCount);
+
+			while (low < high)
+			{
+				const int middle(low + ((high - low) / 2));
+
+				if (m_sourceModel->index(middle, 0).data(HistoryModel::TimeVisitedRole).toDateTime().date() >= m_dates.at(i))
+				{
+					low = (middle + 1);
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			end = low;
+		}
+
+		sizes.append(end - start);
+
+		start = end;
+	}
+
+	return sizes;
+}
+
+int HistoryEntriesModel::rowCount(const QModelIndex &parent) const
+{
+	if (!parent.isValid())
+	{
+		return m_dates.count();
+	}
+
+	if (parent.internalId() != 0 || parent.column() != 0 || parent.row() >= m_groupsSizes.count())
+	{
+		return 0;
+	}
+
+	return (m_isMaterialized ? m_groupsEntries.at(parent.row()).count() : m_groupsSizes.at(parent.row()));
+}
+
+int HistoryEntriesModel::columnCount(const QModelIndex &parent) const
+{
+	Q_UNUSED(parent)
+
+	return 3;
+}
+
+int HistoryEntriesModel::findGroup(int sourceRow) const
+{
+	for (int i = 0; i < m_groupsSizes.count(); ++i)
+	{
+		if (sourceRow >= m_groupsOffsets.at(i) && sourceRow < (m_groupsOffsets.at(i) + m_groupsSizes.at(i)))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int HistoryEntriesModel::findGroup(const QDate &date) const
+{
+	for (int i = 0; i < m_dates.count(); ++i)
+	{
+		if (!m_dates.at(i).isValid() || date >= m_dates.at(i))
+		{
+			return i;
+		}
+	}
+
+	return (m_dates.count() - 1);
+}
+
+int HistoryEntriesModel::mapToSourceRow(int group, int row) const
+{
+	return (m_groupsOffsets.at(group) + row);
+}
+
+bool HistoryEntriesModel::needsMaterialization() const
+{
+	return (isFiltered() || (m_sortColumn >= 0 && !(m_sortColumn == 2 && m_sortOrder == Qt::DescendingOrder)));
+}
+
+bool HistoryEntriesModel::isFiltered() const
+{
+	return !m_filterString.isEmpty();
+}
+
+bool HistoryEntriesModel::event(QEvent *event)
+{
+	if (event->type() == QEvent::LanguageChange)
+	{
+		emit headerDataChanged(Qt::Horizontal, 0, (columnCount() - 1));
+		emit dataChanged(index(0, 0), index((rowCount() - 1), 0));
+	}
+
+	return QAbstractItemModel::event(event);
+}
+
+}
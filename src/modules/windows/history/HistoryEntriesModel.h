@@ -0,0 +1,91 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_HISTORYENTRIESMODEL_H
+#define OTTER_HISTORYENTRIESMODEL_H
+
+#include "../../../core/HistoryModel.h"
+
+#include <QtCore/QAbstractItemModel>
+
+namespace Otter
+{
+
+class HistoryEntriesModel final : public QAbstractItemModel
+{
+	Q_OBJECT
+
+public:
+	enum DataRole
+	{
+		IdentifierRole = Qt::UserRole,
+		TimeVisitedRole,
+		GroupDateRole
+	};
+
+	explicit HistoryEntriesModel(HistoryModel *sourceModel, QObject *parent = nullptr);
+
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+	void setFilterString(const QString &filter);
+	HistoryModel::Entry* getEntry(const QModelIndex &index) const;
+	QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+	QModelIndex parent(const QModelIndex &index) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex &index) const override;
+	int rowCount(const QModelIndex &parent = {}) const override;
+	int columnCount(const QModelIndex &parent = {}) const override;
+	bool isFiltered() const;
+	bool event(QEvent *event) override;
+
+public slots:
+	void updateGroups();
+
+protected:
+	void updateLayout();
+	void updateOffsets();
+	void materializeGroups();
+	QModelIndex findEntry(HistoryModel::Entry *entry) const;
+	QVector<int> calculateGroupsSizes() const;
+	int findGroup(int sourceRow) const;
+	int findGroup(const QDate &date) const;
+	int mapToSourceRow(int group, int row) const;
+	bool needsMaterialization() const;
+
+protected slots:
+	void handleEntryAdded(HistoryModel::Entry *entry);
+	void handleRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+	void handleRowsRemoved(const QModelIndex &parent, int first, int last);
+	void handleDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+private:
+	HistoryModel *m_sourceModel;
+	QString m_filterString;
+	QVector<QDate> m_dates;
+	QVector<QVector<HistoryModel::Entry*> > m_groupsEntries;
+	QVector<int> m_groupsOffsets;
+	QVector<int> m_groupsSizes;
+	Qt::SortOrder m_sortOrder;
+	int m_sortColumn;
+	bool m_isMaterialized;
+};
+
+}
+
+#endif
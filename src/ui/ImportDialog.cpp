@@ -26,6 +26,7 @@
 #include "../modules/importers/opera/OperaSearchEnginesImporter.h"
 #include "../modules/importers/opera/OperaSessionImporter.h"
 #include "../modules/importers/opml/OpmlImporter.h"
+#include "../modules/importers/otter/OtterHistoryImporter.h"
 
 #include "ui_ImportDialog.h"
 
@@ -114,6 +115,10 @@ void ImportDialog::createDialog(const QString &importerName, QWidget *parent)
 	{
 		importer = new OpmlImporter();
 	}
+	else if (importerName == QLatin1String("OtterHistory"))
+	{
+		importer = new OtterHistoryImporter();
+	}
 
 	if (importer)
 	{
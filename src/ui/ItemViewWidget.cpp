@@ -895,6 +895,11 @@ void ItemViewWidget::setFilterRoles(const QSet<int> &roles)
 	m_filterRoles = roles;
 }
 
+void ItemViewWidget::setFilterFunction(const std::function<bool(const QModelIndex &index)> &function)
+{
+	m_filterFunction = function;
+}
+
 void ItemViewWidget::setRowsMovable(bool areMovable)
 {
 	m_areRowsMovable = areMovable;
@@ -1150,7 +1155,11 @@ bool ItemViewWidget::applyFilter(const QModelIndex &index, bool parentHasMatch)
 	const bool hasFilter(!m_filterString.isEmpty());
 	bool hasMatch(!hasFilter || (isFolder && parentHasMatch));
 
-	if (!hasMatch)
+	if (!hasMatch && m_filterFunction)
+	{
+		hasMatch = m_filterFunction(index);
+	}
+	else if (!hasMatch)
 	{
 		for (int i = 0; i < getColumnCount(index.parent()); ++i)
 		{
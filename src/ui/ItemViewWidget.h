@@ -30,6 +30,8 @@
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QTreeView>
 
+#include <functional>
+
 namespace Otter
 {
 
@@ -113,6 +115,7 @@ public:
 	void setSortRoleMapping(const QMap<int, int> &mapping);
 	void setViewMode(ViewMode mode);
 	void setModified(bool isModified);
+	void setFilterFunction(const std::function<bool(const QModelIndex &index)> &function);
 	ViewportWidget* getViewportWidget() const;
 	QStandardItemModel* getSourceModel() const;
 	QSortFilterProxyModel* getProxyModel() const;
@@ -148,6 +151,7 @@ public slots:
 	void setFilterString(const QString &filter);
 	void setFilterRoles(const QSet<int> &roles);
 	void setRowsMovable(bool areMovable);
+	void updateFilter();
 
 protected:
 	void showEvent(QShowEvent *event) override;
@@ -166,7 +170,6 @@ protected slots:
 	void saveState();
 	void handleOptionChanged(int identifier, const QVariant &value);
 	void notifySelectionChanged();
-	void updateFilter();
 	void updateSize();
 
 private:
@@ -178,6 +181,7 @@ private:
 	QMap<int, int> m_sortRoleMapping;
 	QSet<QModelIndex> m_expandedBranches;
 	QSet<int> m_filterRoles;
+	std::function<bool(const QModelIndex &index)> m_filterFunction;
 	ViewMode m_viewMode;
 	Qt::SortOrder m_sortOrder;
 	int m_sortColumn;
@@ -31,6 +31,7 @@
 #include "StatusBarWidget.h"
 #include "TabBarWidget.h"
 #include "TabSwitcherWidget.h"
+#include "TabsLoadingScheduler.h"
 #include "ToolBarDropZoneWidget.h"
 #include "ToolBarWidget.h"
 #include "WidgetFactory.h"
@@ -69,6 +70,7 @@ MainWindow::MainWindow(const QVariantMap &parameters, const Session::MainWindow
 	m_tabBar(new TabBarWidget(this)),
 	m_menuBar(nullptr),
 	m_statusBar(nullptr),
+	m_tabsLoadingScheduler(nullptr),
 	m_activeWindow(nullptr),
 	m_identifier(++m_identifierCounter),
 	m_mouseTrackerTimer(0),
@@ -1026,7 +1028,7 @@ void MainWindow::triggerAction(int identifier, const QVariantMap &parameters, Ac
 						break;
 				}
 
-				SessionsManager::markSessionAsModified();
+				SessionsManager::markSessionAsModified(this);
 
 				emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 				emit toolBarStateChanged(toolBarIdentifier, getToolBarState(toolBarIdentifier));
@@ -1242,6 +1244,7 @@ void MainWindow::search(const QString &query, const QString &searchEngine, Sessi
 
 void MainWindow::restoreSession(const Session::MainWindow &session)
 {
+	QVector<QPair<Window*, bool> > restoredWindows;
 	int index(session.index);
 
 	if (index >= session.windows.count())
@@ -1274,7 +1277,9 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 			}
 
 			Window *window(new Window(parameters, nullptr, this));
-			window->setSession(session.windows.at(i), SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool());
+			window->setSession(session.windows.at(i), true);
+
+			restoredWindows.append({window, (session.windows.at(i).isPinned || session.windows.at(i).state.state == Qt::WindowNoState)});
 
 			if (index < 0 && session.windows.at(i).state.state != Qt::WindowMinimized)
 			{
@@ -1291,6 +1296,27 @@ void MainWindow::restoreSession(const Session::MainWindow &session)
 
 	setActiveWindowByIndex(index);
 
+	if (!restoredWindows.isEmpty() && !SettingsManager::getOption(SettingsManager::Sessions_DeferTabsLoadingOption).toBool())
+	{
+		if (!m_tabsLoadingScheduler)
+		{
+			m_tabsLoadingScheduler = new TabsLoadingScheduler(this);
+		}
+
+		if (m_activeWindow)
+		{
+			m_tabsLoadingScheduler->scheduleWindow(m_activeWindow, true);
+		}
+
+		for (int i = 0; i < restoredWindows.count(); ++i)
+		{
+			if (restoredWindows.at(i).first != m_activeWindow)
+			{
+				m_tabsLoadingScheduler->scheduleWindow(restoredWindows.at(i).first, restoredWindows.at(i).second);
+			}
+		}
+	}
+
 	m_workspace->markAsRestored();
 
 	emit sessionRestored();
@@ -1530,7 +1556,7 @@ void MainWindow::setSplitterSizes(const QString &identifier, const QVector<int>
 	{
 		m_splitters[identifier] = sizes;
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 	}
 }
 
@@ -1826,7 +1852,7 @@ void MainWindow::handleToolBarAdded(int identifier)
 
 	m_toolBars[identifier] = toolBar;
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 
 	emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 }
@@ -1842,7 +1868,7 @@ void MainWindow::handleToolBarRemoved(int identifier)
 
 		toolBar->deleteLater();
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit arbitraryActionsStateChanged({ActionsManager::ShowToolBarAction});
 	}
@@ -2659,7 +2685,7 @@ bool MainWindow::event(QEvent *event)
 
 			break;
 		case QEvent::Move:
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			break;
 		case QEvent::Resize:
@@ -2668,7 +2694,7 @@ bool MainWindow::event(QEvent *event)
 				m_tabSwitcher->resize(size());
 			}
 
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			break;
 		case QEvent::StatusTip:
@@ -2677,7 +2703,7 @@ bool MainWindow::event(QEvent *event)
 			break;
 		case QEvent::WindowStateChange:
 			{
-				SessionsManager::markSessionAsModified();
+				SessionsManager::markSessionAsModified(this);
 
 				if (windowState().testFlag(Qt::WindowFullScreen) != static_cast<QWindowStateChangeEvent*>(event)->oldState().testFlag(Qt::WindowFullScreen))
 				{
@@ -2740,7 +2766,7 @@ bool MainWindow::event(QEvent *event)
 
 			break;
 		case QEvent::WindowActivate:
-			SessionsManager::markSessionAsModified();
+			SessionsManager::markSessionAsModified(this);
 
 			emit activated();
 
@@ -45,6 +45,7 @@ class Shortcut;
 class StatusBarWidget;
 class TabBarWidget;
 class TabSwitcherWidget;
+class TabsLoadingScheduler;
 class ToolBarWidget;
 class Window;
 class WorkspaceWidget;
@@ -135,6 +136,7 @@ private:
 	TabBarWidget *m_tabBar;
 	MenuBarWidget *m_menuBar;
 	StatusBarWidget *m_statusBar;
+	TabsLoadingScheduler *m_tabsLoadingScheduler;
 	QPointer<Window> m_activeWindow;
 	QString m_windowTitle;
 	ActionExecutor::Object m_editorExecutor;
@@ -43,6 +43,7 @@
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QTextCodec>
 #include <QtGui/QMouseEvent>
+#include <QtWidgets/QMessageBox>
 
 namespace Otter
 {
@@ -149,6 +150,9 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 			addSeparator();
 			addAction(new Action(-1, {{QLatin1String("importer"), QLatin1String("OperaNotes")}}, {{QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Import Opera Notes…")}}, ActionExecutor::Object(), this));
 			addSeparator();
+			addAction(new Action(-1, {{QLatin1String("importer"), QLatin1String("OtterHistory")}}, {{QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Import History…")}}, ActionExecutor::Object(), this));
+			addAction(new Action(-1, {{QLatin1String("exporter"), QLatin1String("OtterHistory")}}, {{QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Export History…")}}, ActionExecutor::Object(), this));
+			addSeparator();
 			addAction(new Action(-1, {{QLatin1String("importer"), QLatin1String("OperaSearchEngines")}}, {{QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Import Opera Search Engines…")}}, ActionExecutor::Object(), this));
 			addSeparator();
 			addAction(new Action(-1, {{QLatin1String("importer"), QLatin1String("OperaSession")}}, {{QLatin1String("text"), QT_TRANSLATE_NOOP("actions", "Import Opera Session…")}}, ActionExecutor::Object(), this));
@@ -168,9 +172,25 @@ Menu::Menu(int role, QWidget *parent) : QMenu(parent),
 
 			connect(this, &Menu::triggered, this, [&](QAction *action)
 			{
-				if (action)
+				if (!action)
+				{
+					return;
+				}
+
+				const QVariantMap parameters(qobject_cast<Action*>(action)->getParameters());
+
+				if (parameters.value(QLatin1String("exporter")).toString() == QLatin1String("OtterHistory"))
+				{
+					const SaveInformation information(Utils::getSavePath(QLatin1String("browsingHistory.json"), {}, {tr("Otter Browser history files (*.json)")}));
+
+					if (information.canSave && !HistoryManager::getBrowsingHistoryModel()->save(information.path))
+					{
+						QMessageBox::critical(MainWindow::findMainWindow(this), tr("Error"), tr("Failed to export history."));
+					}
+				}
+				else
 				{
-					ImportDialog::createDialog(qobject_cast<Action*>(action)->getParameters().value(QLatin1String("importer")).toString(), MainWindow::findMainWindow(this));
+					ImportDialog::createDialog(parameters.value(QLatin1String("importer")).toString(), MainWindow::findMainWindow(this));
 				}
 			});
 
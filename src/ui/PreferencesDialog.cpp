@@ -27,6 +27,7 @@
 #include "preferences/PreferencesSearchPageWidget.h"
 #include "../core/Application.h"
 #include "../core/SessionsManager.h"
+#include "../core/SettingsManager.h"
 
 #include "ui_PreferencesDialog.h"
 
@@ -210,8 +211,12 @@ void PreferencesDialog::markAsModified()
 
 void PreferencesDialog::save()
 {
+	SettingsManager::beginBatch();
+
 	emit requestedSave();
 
+	SettingsManager::endBatch();
+
 	if (sender() == m_ui->buttonBox)
 	{
 		close();
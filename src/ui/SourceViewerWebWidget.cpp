@@ -288,7 +288,7 @@ void SourceViewerWebWidget::handleViewSourceReplyFinished()
 
 void SourceViewerWebWidget::handleZoomChanged()
 {
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 }
 
 void SourceViewerWebWidget::notifyEditingActionsStateChanged()
@@ -346,7 +346,7 @@ void SourceViewerWebWidget::setZoom(int zoom)
 	{
 		m_sourceEditWidget->setZoom(zoom);
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit zoomChanged(zoom);
 	}
@@ -0,0 +1,157 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "TabsLoadingScheduler.h"
+#include "Window.h"
+#include "../core/SettingsManager.h"
+
+#include <QtCore/QTimerEvent>
+#include <QtWidgets/QApplication>
+
+namespace Otter
+{
+
+TabsLoadingScheduler::TabsLoadingScheduler(QObject *parent) : QObject(parent),
+	m_schedulerTimer(0)
+{
+}
+
+void TabsLoadingScheduler::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_schedulerTimer)
+	{
+		return;
+	}
+
+	updateLoadingWindows();
+
+	if (!isUserInteracting())
+	{
+		const int limit(qMax(1, SettingsManager::getOption(SettingsManager::Sessions_ConcurrentTabsLoadingLimitOption).toInt()));
+
+		while (m_loadingWindows.count() < limit)
+		{
+			Window *window(takeNextWindow());
+
+			if (!window)
+			{
+				break;
+			}
+
+			if (window->getLoadingState() == WebWidget::DeferredLoadingState)
+			{
+				window->getContentsWidget();
+
+				trackWindow(window);
+
+				break;
+			}
+
+			if (window->getLoadingState() == WebWidget::OngoingLoadingState)
+			{
+				trackWindow(window);
+			}
+		}
+	}
+
+	if (isEmpty())
+	{
+		killTimer(m_schedulerTimer);
+
+		m_schedulerTimer = 0;
+	}
+}
+
+void TabsLoadingScheduler::scheduleWindow(Window *window, bool isPriority)
+{
+	if (!window)
+	{
+		return;
+	}
+
+	if (isPriority)
+	{
+		m_priorityWindows.append(window);
+	}
+	else
+	{
+		m_backgroundWindows.append(window);
+	}
+
+	if (m_schedulerTimer == 0)
+	{
+		m_schedulerTimer = startTimer(250);
+	}
+}
+
+void TabsLoadingScheduler::updateLoadingWindows()
+{
+	for (int i = (m_loadingWindows.count() - 1); i >= 0; --i)
+	{
+		LoadingWindow &loadingWindow(m_loadingWindows[i]);
+		const WebWidget::LoadingState state(loadingWindow.window ? loadingWindow.window->getLoadingState() : WebWidget::DeferredLoadingState);
+
+		if (state == WebWidget::OngoingLoadingState)
+		{
+			loadingWindow.hasStarted = true;
+		}
+
+		if (state == WebWidget::DeferredLoadingState || loadingWindow.timer.hasExpired(30000) || (state != WebWidget::OngoingLoadingState && (loadingWindow.hasStarted || loadingWindow.timer.hasExpired(2000))))
+		{
+			m_loadingWindows.removeAt(i);
+		}
+	}
+}
+
+void TabsLoadingScheduler::trackWindow(Window *window)
+{
+	LoadingWindow loadingWindow;
+	loadingWindow.window = window;
+	loadingWindow.timer.start();
+	loadingWindow.hasStarted = (window->getLoadingState() == WebWidget::OngoingLoadingState);
+
+	m_loadingWindows.append(loadingWindow);
+}
+
+Window* TabsLoadingScheduler::takeNextWindow()
+{
+	while (!m_priorityWindows.isEmpty() || !m_backgroundWindows.isEmpty())
+	{
+		const QPointer<Window> window(m_priorityWindows.isEmpty() ? m_backgroundWindows.takeFirst() : m_priorityWindows.takeFirst());
+
+		if (window && !window->isAboutToClose())
+		{
+			return window;
+		}
+	}
+
+	return nullptr;
+}
+
+bool TabsLoadingScheduler::isUserInteracting()
+{
+	return (QApplication::mouseButtons() != Qt::NoButton || QApplication::activePopupWidget() || QApplication::activeModalWidget());
+}
+
+bool TabsLoadingScheduler::isEmpty() const
+{
+	return (m_priorityWindows.isEmpty() && m_backgroundWindows.isEmpty() && m_loadingWindows.isEmpty());
+}
+
+}
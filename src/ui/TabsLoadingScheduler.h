@@ -0,0 +1,66 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2021 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_TABSLOADINGSCHEDULER_H
+#define OTTER_TABSLOADINGSCHEDULER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+class Window;
+
+class TabsLoadingScheduler final : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit TabsLoadingScheduler(QObject *parent = nullptr);
+
+	void scheduleWindow(Window *window, bool isPriority = false);
+	bool isEmpty() const;
+
+protected:
+	struct LoadingWindow final
+	{
+		QPointer<Window> window;
+		QElapsedTimer timer;
+		bool hasStarted = false;
+	};
+
+	void timerEvent(QTimerEvent *event) override;
+	void updateLoadingWindows();
+	void trackWindow(Window *window);
+	Window* takeNextWindow();
+	static bool isUserInteracting();
+
+private:
+	QVector<QPointer<Window> > m_priorityWindows;
+	QVector<QPointer<Window> > m_backgroundWindows;
+	QVector<LoadingWindow> m_loadingWindows;
+	int m_schedulerTimer;
+};
+
+}
+
+#endif
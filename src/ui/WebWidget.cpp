@@ -54,6 +54,7 @@ WebWidget::WebWidget(const QVariantMap &parameters, WebBackend *backend, Content
 	m_parent(parent),
 	m_backend(backend),
 	m_windowIdentifier(0),
+	m_hostOptionsRevision(-1),
 	m_loadingTime(0),
 	m_loadingTimer(0),
 	m_reloadTimer(0),
@@ -223,14 +224,13 @@ void WebWidget::startTransfer(Transfer *transfer)
 
 void WebWidget::clearOptions()
 {
-	const QString host(Utils::extractHost(getUrl()));
 	const QList<int> identifiers(m_options.keys());
 
 	m_options.clear();
 
 	for (int i = 0; i < identifiers.count(); ++i)
 	{
-		emit optionChanged(identifiers.at(i), SettingsManager::getOption(identifiers.at(i), host));
+		emit optionChanged(identifiers.at(i), getOption(identifiers.at(i)));
 	}
 
 	emit arbitraryActionsStateChanged({ActionsManager::ResetQuickPreferencesAction});
@@ -660,7 +660,7 @@ void WebWidget::setOption(int identifier, const QVariant &value)
 		m_options[identifier] = value;
 	}
 
-	SessionsManager::markSessionAsModified();
+	SessionsManager::markSessionAsModified(this);
 
 	switch (identifier)
 	{
@@ -730,18 +730,9 @@ void WebWidget::setOptions(const QHash<int, QVariant> &options, const QStringLis
 		}
 	}
 
-	const QString host(Utils::extractHost(getUrl()));
-
 	for (int i = 0; i < identifiers.count(); ++i)
 	{
-		if (m_options.contains(identifiers.at(i)))
-		{
-			emit optionChanged(identifiers.at(i), m_options[identifiers.at(i)]);
-		}
-		else
-		{
-			emit optionChanged(identifiers.at(i), SettingsManager::getOption(identifiers.at(i), host));
-		}
+		emit optionChanged(identifiers.at(i), getOption(identifiers.at(i)));
 	}
 
 	emit arbitraryActionsStateChanged({ActionsManager::ResetQuickPreferencesAction});
@@ -974,7 +965,21 @@ QVariant WebWidget::getOption(int identifier, const QUrl &url) const
 		return m_options[identifier];
 	}
 
-	return SettingsManager::getOption(identifier, Utils::extractHost(url.isEmpty() ? getUrl() : url));
+	const QString host(Utils::extractHost(url.isEmpty() ? getUrl() : url));
+
+	if (host != m_hostOptionsHost || m_hostOptionsRevision != SettingsManager::getOptionsRevision())
+	{
+		if (!url.isEmpty() && host != Utils::extractHost(getUrl()))
+		{
+			return SettingsManager::getOption(identifier, host);
+		}
+
+		m_hostOptions = SettingsManager::getHostOptions(host);
+		m_hostOptionsHost = host;
+		m_hostOptionsRevision = SettingsManager::getOptionsRevision();
+	}
+
+	return m_hostOptions.value(identifier);
 }
 
 QVariant WebWidget::getPageInformation(PageInformation key) const
@@ -329,7 +329,10 @@ private:
 	QHash<int, QVariant> m_options;
 	QHash<ChangeWatcher, QVector<QObject*> > m_changeWatchers;
 	HitTestResult m_hitResult;
+	mutable QString m_hostOptionsHost;
+	mutable QVector<QVariant> m_hostOptions;
 	quint64 m_windowIdentifier;
+	mutable int m_hostOptionsRevision;
 	int m_loadingTime;
 	int m_loadingTimer;
 	int m_reloadTimer;
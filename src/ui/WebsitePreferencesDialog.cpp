@@ -270,6 +270,7 @@ void WebsitePreferencesDialog::handleButtonClicked(QAbstractButton *button)
 	switch (m_ui->buttonBox->buttonRole(button))
 	{
 		case QDialogButtonBox::AcceptRole:
+			SettingsManager::beginBatch();
 			SettingsManager::setOption(SettingsManager::Content_DefaultCharacterEncodingOption, (m_ui->encodingOverrideCheckBox->isChecked() ? m_ui->encodingComboBox->currentData(Qt::UserRole).toString() : QVariant()), host);
 			SettingsManager::setOption(SettingsManager::Permissions_ScriptsCanOpenWindowsOption, (m_ui->popupsPolicyOverrideCheckBox->isChecked() ? m_ui->popupsPolicyComboBox->currentData(Qt::UserRole).toString() : QVariant()), host);
 			SettingsManager::setOption(SettingsManager::Permissions_EnableImagesOption, (m_ui->enableImagesOverrideCheckBox->isChecked() ? m_ui->enableImagesComboBox->currentData(Qt::UserRole).toString() : QVariant()), host);
@@ -300,6 +301,8 @@ void WebsitePreferencesDialog::handleButtonClicked(QAbstractButton *button)
 				SettingsManager::setOption(SettingsManager::ContentBlocking_ProfilesOption, {}, host);
 			}
 
+			SettingsManager::endBatch();
+
 			accept();
 
 			break;
@@ -334,7 +334,7 @@ void Window::setOption(int identifier, const QVariant &value)
 			m_session.options[identifier] = value;
 		}
 
-		SessionsManager::markSessionAsModified();
+		SessionsManager::markSessionAsModified(this);
 
 		emit optionChanged(identifier, value);
 	}